@@ -2,13 +2,17 @@
 #include <vector>
 #include <algorithm>
 #include <cmath>
+#include <atomic>
+#include <optional>
+#include "../runtime/work_stealing.cpp"
 
 using namespace std;
 
 typedef long long ll;
 
 ll K;
-ll ans = 1e18;
+// best N so far, shared by the forked searches
+atomic<ll> ans{static_cast<ll>(1e18)};
 vector<ll> primes;
 
 bool is_prime(ll n) {
@@ -46,13 +50,19 @@ void generate_primes(vector<ll>& primes) {
 // idx: current index in exponents
 // result: current N being constructed
 // prime_idx: current prime index to use
+void update_ans(ll result) {
+    ll cur = ans.load(memory_order_relaxed);
+    while (result < cur && !ans.compare_exchange_weak(cur, result, memory_order_relaxed)) {}
+}
+
 void dfs(vector<ll>& exponents, int idx, ll result, int prime_idx) {
     if (idx == exponents.size()) {
-        ans = min(ans, result);
+        update_ans(result);
         return;
     }
     
-    if (ans <= result) return; // Pruning
+    ll best = ans.load(memory_order_relaxed);
+    if (best <= result) return; // Pruning
     if (prime_idx >= primes.size()) return; // Out of primes
     
     ll exp = exponents[idx];
@@ -62,7 +72,7 @@ void dfs(vector<ll>& exponents, int idx, ll result, int prime_idx) {
     ll term = 1;
     bool overflow = false;
     for (ll i = 0; i < exp; ++i) {
-        if (term > ans / p) {
+        if (term > best / p) {
             overflow = true;
             break;
         }
@@ -71,11 +81,14 @@ void dfs(vector<ll>& exponents, int idx, ll result, int prime_idx) {
     
     if (overflow) return;
     
-    if (result > ans / term) return; // Would overflow or exceed ans
+    if (result > best / term) return; // Would overflow or exceed ans
     
     dfs(exponents, idx + 1, result * term, prime_idx + 1);
 }
 
+// factorizations with fewer factors than this are searched as forked tasks on the shared runtime
+const size_t FORK_DEPTH = 2;
+
 // Factorize K and find all ways to express K as product of positive integers
 void factorize_and_search(ll k, vector<ll>& current_factors, int min_divisor) {
     if (k == 1) {
@@ -87,9 +100,19 @@ void factorize_and_search(ll k, vector<ll>& current_factors, int min_divisor) {
         return;
     }
     
-    // Try all divisors >= min_divisor
+    // Try all divisors >= min_divisor; only the top FORK_DEPTH levels fork, so only they
+    // touch the pool
+    optional<ws::TaskGroup> forks;
+    if (current_factors.size() < FORK_DEPTH) forks.emplace();
     for (ll d = min_divisor; d * d <= k; ++d) {
         if (k % d == 0) {
+            if (forks) {
+                forks->run([k, d, factors = current_factors]() mutable {
+                    factors.push_back(d);
+                    factorize_and_search(k / d, factors, d);
+                });
+                continue;
+            }
             current_factors.push_back(d);
             factorize_and_search(k / d, current_factors, d);
             current_factors.pop_back();
@@ -100,8 +123,10 @@ void factorize_and_search(ll k, vector<ll>& current_factors, int min_divisor) {
     current_factors.push_back(k);
     dfs(current_factors, 0, 1, 0);
     current_factors.pop_back();
+    if (forks) forks->wait();
 }
 
+#ifndef ADMISSION_TO_EXAM_NO_MAIN
 int main() {
     if (!(cin >> K)) return 0;
 
@@ -115,7 +140,7 @@ int main() {
     vector<ll> factors;
     factorize_and_search(K, factors, 2);
     
-    if (ans == 1e18) {
+    if (ans.load() == static_cast<ll>(1e18)) {
         cout << 0 << endl;
     } else {
         cout << ans << endl;
@@ -123,3 +148,4 @@ int main() {
 
     return 0;
 }
+#endif
@@ -49,6 +49,8 @@ bTernary dec2ter(int x) {
     return rResult;
 }
 
+// define BALANCE_TERNARY_NO_MAIN to include dec2ter() from another file
+#ifndef BALANCE_TERNARY_NO_MAIN
 int main() {
     // Test cases
     int test_cases[] = {0, 1, 2, 3, 4, 5, 9, 10, -1, -2, -5, 27};
@@ -67,4 +69,4 @@ int main() {
     
     return 0;
 }
-
+#endif
@@ -0,0 +1,92 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <memory>
+#include "combinatorics.cpp"
+
+// 10^6 binomials mod 1e9+7: FactorialTable batch vs one power() inverse per query,
+// plus Lucas (mod 10007) and the composite CRT path (mod 10^6 = 2^6 * 5^6).
+// build: g++ -std=c++17 -O2 bench_combinatorics.cpp
+using clk = std::chrono::steady_clock;
+
+// C(n, k) mod p digit by digit, each digit binomial by the multiplicative formula
+uint32_t lucas_reference(uint64_t n, uint64_t k, uint32_t p) {
+    uint64_t res = 1;
+    for (; n > 0 || k > 0; n /= p, k /= p) {
+        uint64_t ni = n % p, ki = k % p;
+        if (ki > ni) return 0;
+        for (uint64_t j = 0; j < ki; ++j) res = res * (ni - j) % p * mod_inverse_prime(j + 1, p) % p;
+    }
+    return static_cast<uint32_t>(res);
+}
+
+template <typename F>
+double ms(F f) {
+    auto start = clk::now();
+    f();
+    return std::chrono::duration<double, std::milli>(clk::now() - start).count();
+}
+
+int main() {
+    using namespace std;
+    const uint32_t P = 1000000007;
+    const uint32_t N = 1000000;
+    const size_t Q = 1000000;
+    mt19937_64 rng(12345);
+    vector<binom_query> qs(Q);
+    for (auto& q : qs) {
+        q.first = rng() % (N + 1);
+        q.second = rng() % (q.first + 1);
+    }
+    vector<uint32_t> out(Q), ref(Q);
+    cout << fixed << setprecision(1);
+
+    // baseline: factorials only, inverses by Fermat through power() on every query
+    vector<uint32_t> fact(N + 1, 1);
+    double t_fact = ms([&] {
+        for (uint32_t i = 1; i <= N; ++i) fact[i] = static_cast<uint32_t>(uint64_t(fact[i - 1]) * i % P);
+    });
+    ModMultiply mul(P);
+    double t_power = ms([&] {
+        for (size_t i = 0; i < Q; ++i) {
+            uint64_t n = qs[i].first, k = qs[i].second;
+            uint64_t den = uint64_t(fact[k]) * fact[n - k] % P;
+            ref[i] = static_cast<uint32_t>(fact[n] * power<uint64_t>(den, P - 2, 1, mul) % P);
+        }
+    });
+    cout << "power() per query:      build " << t_fact << " ms, queries " << t_power << " ms\n";
+
+    unique_ptr<FactorialTable> table;
+    double t_build = ms([&] { table.reset(new FactorialTable(N, P)); });
+    double t_batch = ms([&] { table->binom_batch(qs.data(), Q, out.data()); });
+    bool table_ok = out == ref;
+    cout << "FactorialTable batch:   build " << t_build << " ms, queries " << t_batch << " ms"
+         << (table_ok ? "" : "  MISMATCH") << "\n";
+
+    for (auto& q : qs) {
+        q.first = rng() % 1000000000000000000ull;
+        q.second = rng() % (q.first + 1);
+    }
+    unique_ptr<BinomialMod> lucas;
+    t_build = ms([&] { lucas.reset(new BinomialMod(10007, UINT64_MAX)); });
+    t_batch = ms([&] { lucas->binom_batch(qs.data(), Q, out.data()); });
+    bool lucas_ok = true;
+    for (size_t i = 0; i < Q; i += Q / 1000) lucas_ok &= out[i] == lucas_reference(qs[i].first, qs[i].second, 10007);
+    cout << "Lucas mod 10007:        build " << t_build << " ms, queries " << t_batch << " ms (n < 1e18)"
+         << (lucas_ok ? "" : "  MISMATCH") << "\n";
+
+    unique_ptr<BinomialMod> composite;
+    t_build = ms([&] { composite.reset(new BinomialMod(1000000, UINT64_MAX)); });
+    t_batch = ms([&] { composite->binom_batch(qs.data(), Q, out.data()); });
+    // the recombined value must reduce to each prime-power factor's own answer
+    PrimePowerBinomial mod64(2, 6), mod15625(5, 6);
+    bool crt_ok = true;
+    for (size_t i = 0; i < Q; i += Q / 1000) {
+        crt_ok &= out[i] % 64 == mod64.binom(qs[i].first, qs[i].second);
+        crt_ok &= out[i] % 15625 == mod15625.binom(qs[i].first, qs[i].second);
+    }
+    cout << "CRT mod 2^6 * 5^6:      build " << t_build << " ms, queries " << t_batch << " ms (n < 1e18)"
+         << (crt_ok ? "" : "  MISMATCH") << "\n";
+    return table_ok && lucas_ok && crt_ok ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "totient_function.cpp"
+#include "linear_sieve.cpp"
+
+// time and peak memory of the generic LinearSieve against totient_range_eratosthenes / totient_range_euler.
+// each variant runs in a forked child so its peak RSS is measured in isolation.
+// build: g++ -std=c++17 -O2 bench_linear_sieve.cpp && ./a.out [n = 1e8]
+using namespace sieve_policy;
+
+template <typename F>
+void run_isolated(const char* name, F f) {
+    std::cout << std::flush;
+    pid_t pid = fork();
+    if (pid == 0) {
+        auto start = std::chrono::steady_clock::now();
+        long long checksum = f();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::left << std::setw(34) << name << std::fixed << std::setprecision(2)
+                  << std::right << std::setw(8) << sec << " s" << std::flush;
+        _exit(static_cast<int>(checksum & 0x7f));
+    }
+    int status = 0;
+    rusage usage{};
+    wait4(pid, &status, 0, &usage);
+    std::cout << std::setw(10) << usage.ru_maxrss / 1024 << " MiB peak RSS\n";
+}
+
+int main(int argc, char** argv) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 100000000;
+
+    // quick sanity check against the existing implementations; test_linear_sieve.cpp checks every policy
+    {
+        vec ref = totient_range_euler(100000);
+        LinearSieve<Phi, Mobius, DivisorCount, DivisorSum, Omega, SmallestPrimeFactor> s(100000);
+        for (int i = 1; i <= 100000; ++i) {
+            if (static_cast<int>(s.at<Phi>(i)) != ref[i]) {
+                std::cerr << "phi mismatch at " << i << "\n";
+                return 1;
+            }
+        }
+        if (s.at<Mobius>(30) != -1 || s.at<DivisorCount>(36) != 9 || s.at<DivisorSum>(12) != 28 ||
+            s.at<Omega>(60) != 3 || s.at<SmallestPrimeFactor>(91) != 7 || s.prime_count() != 9592) {
+            std::cerr << "policy mismatch\n";
+            return 1;
+        }
+    }
+
+    std::cout << "n = " << n << "\n";
+    run_isolated("totient_range_eratosthenes", [&] { return (long long)totient_range_eratosthenes(n)[n]; });
+    run_isolated("totient_range_euler", [&] { return (long long)totient_range_euler(n)[n]; });
+    run_isolated("LinearSieve<Phi>", [&] {
+        LinearSieve<Phi> s(n);
+        return (long long)s.at<Phi>(n);
+    });
+    run_isolated("LinearSieve<Mobius, Omega>", [&] {
+        LinearSieve<Mobius, Omega> s(n);
+        return (long long)s.at<Mobius>(n) + s.at<Omega>(n);
+    });
+    run_isolated("LinearSieve<all six policies>", [&] {
+        LinearSieve<Phi, Mobius, DivisorCount, DivisorSum, Omega, SmallestPrimeFactor> s(n);
+        return (long long)s.at<Phi>(n) + s.at<DivisorSum>(n);
+    });
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "packed_ternary.cpp"
+
+// 1e6 operations on PackedTernary against a round trip through int64_t (to_int64, operate,
+// convert back), plus wide (1024-trit) add / compare and multiplication.
+// build: g++ -std=c++17 -O2 bench_packed_ternary.cpp
+template <typename F>
+double ns_per_op(int ops, F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ops;
+}
+
+int main() {
+    using namespace std;
+    const int Q = 1000000;
+    mt19937_64 rng(2024);
+    // |value| < 2^60 keeps every sum and difference inside int64_t
+    vector<PackedTernary> a(Q), b(Q), out(Q);
+    vector<int64_t> ia(Q), ib(Q);
+    for (int i = 0; i < Q; ++i) {
+        ia[i] = static_cast<int64_t>(rng() >> 4) * ((rng() & 1) ? 1 : -1);
+        ib[i] = static_cast<int64_t>(rng() >> 4) * ((rng() & 1) ? 1 : -1);
+        a[i] = PackedTernary(ia[i]);
+        b[i] = PackedTernary(ib[i]);
+    }
+    long long sink = 0;
+    cout << fixed << setprecision(1) << "ns/op over " << Q << " ops, 38-trit operands\n";
+    cout << setw(12) << "op" << setw(14) << "packed" << setw(22) << "via int64 round trip" << "\n";
+    auto row = [&](const char* name, double packed, double binary) {
+        cout << setw(12) << name << setw(14) << packed;
+        if (binary > 0) cout << setw(22) << binary;
+        cout << "\n";
+    };
+    row("add",
+        ns_per_op(Q, [&] { for (int i = 0; i < Q; ++i) out[i] = a[i] + b[i]; }),
+        ns_per_op(Q, [&] { for (int i = 0; i < Q; ++i) out[i] = PackedTernary(a[i].to_int64() + b[i].to_int64()); }));
+    for (int i = 0; i < Q; i += 997) if (out[i].to_int64() != ia[i] + ib[i]) { cout << "add mismatch\n"; return 1; }
+    row("sub",
+        ns_per_op(Q, [&] { for (int i = 0; i < Q; ++i) out[i] = a[i] - b[i]; }),
+        ns_per_op(Q, [&] { for (int i = 0; i < Q; ++i) out[i] = PackedTernary(a[i].to_int64() - b[i].to_int64()); }));
+    row("negate",
+        ns_per_op(Q, [&] { for (int i = 0; i < Q; ++i) a[i].negate(); }),
+        ns_per_op(Q, [&] { for (int i = 0; i < Q; ++i) a[i] = PackedTernary(-a[i].to_int64()); }));
+    row("compare",
+        ns_per_op(Q, [&] { for (int i = 0; i < Q; ++i) sink += compare(a[i], b[i]); }),
+        ns_per_op(Q, [&] { for (int i = 0; i < Q; ++i) sink += a[i].to_int64() < b[i].to_int64(); }));
+    row("tritwise max",
+        ns_per_op(Q, [&] { for (int i = 0; i < Q; ++i) out[i] = tritwise_max(a[i], b[i]); }),
+        -1);   // no binary counterpart
+    vector<PackedTernary> sa(Q), sb(Q);
+    for (int i = 0; i < Q; ++i) {
+        sa[i] = PackedTernary(ia[i] >> 31);
+        sb[i] = PackedTernary(ib[i] >> 31);
+    }
+    row("mul",
+        ns_per_op(Q, [&] { for (int i = 0; i < Q; ++i) out[i] = sa[i] * sb[i]; }),
+        ns_per_op(Q, [&] { for (int i = 0; i < Q; ++i) out[i] = PackedTernary(sa[i].to_int64() * sb[i].to_int64()); }));
+    for (int i = 0; i < Q; i += 997) if (out[i].to_int64() != (ia[i] >> 31) * (ib[i] >> 31)) { cout << "mul mismatch\n"; return 1; }
+
+    // wide operands, in place on the raw words
+    const size_t W = 32, R = 100000;   // 1024 trits
+    vector<uint64_t> x(W), y(W);
+    for (size_t i = 0; i < W; ++i) {
+        uint64_t p = rng(), n = rng() & ~p;
+        x[i] = (p & 0xffffffffu) | (n << 32);
+        p = rng(), n = rng() & ~p;
+        y[i] = (p & 0xffffffffu) | (n << 32);
+    }
+    cout << "\n1024-trit operands, ns/op: add "
+         << ns_per_op(R, [&] { for (size_t i = 0; i < R; ++i) sink += ternary_add(x.data(), x.data(), y.data(), W); })
+         << ", compare " << ns_per_op(R, [&] { for (size_t i = 0; i < R; ++i) sink += ternary_compare(x.data(), y.data(), W); })
+         << ", negate " << ns_per_op(R, [&] { for (size_t i = 0; i < R; ++i) ternary_negate(x.data(), W); }) << "\n";
+    PackedTernary big = PackedTernary::from_chars(bTernary(1000, '1'));
+    cout << "1000 x 1000-trit multiply: "
+         << ns_per_op(1000, [&] { for (int i = 0; i < 1000; ++i) sink += (big * big).words(); }) / 1000 << " us\n";
+    if (sink == 42) cout << "";
+    return 0;
+}
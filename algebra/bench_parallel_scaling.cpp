@@ -0,0 +1,64 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include "totient_function.cpp"
+#include "trial_divisor.cpp"
+#include "sublinear_prefix_sum.cpp"
+#define ADMISSION_TO_EXAM_NO_MAIN
+#include "admission_to_exam.cpp"
+
+// scaling of the algebra kernels on the shared work-stealing runtime, 1 .. N threads: each row
+// resizes the pool with ws::set_num_threads and passes the same count to DuSieve.
+// build: g++ -std=c++17 -O2 -pthread bench_parallel_scaling.cpp && ./a.out [sieve n = 1e8]
+template <typename F>
+double seconds(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    const int n = argc > 1 ? std::atoi(argv[1]) : 100000000;
+    const int hw = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> thread_counts;
+    for (int t = 1; t <= std::max(hw, 4); t *= 2) thread_counts.push_back(t);
+    if (thread_counts.back() != hw && hw > 4) thread_counts.push_back(hw);
+
+    std::vector<int> to_factor(100000);
+    for (size_t i = 0; i < to_factor.size(); ++i) to_factor[i] = 2000000000 + static_cast<int>(i) * 97;
+    generate_primes(primes);
+    const long long admission_k = 7351344000LL;
+
+    long long sink = 0;
+    double serial = seconds([&] { sink += totient_range_eratosthenes(n)[n]; });
+    std::cout << "hardware threads: " << hw << "\n" << "totient_range_eratosthenes(" << n << ") serial baseline: "
+              << std::fixed << std::setprecision(3) << serial << " s\n\n";
+    std::cout << std::setw(8) << "threads" << std::setw(22) << "totient_range_par s" << std::setw(22) << "factorize batch s"
+              << std::setw(22) << "admission search s" << std::setw(22) << "DuSieve(1e11) s" << "\n";
+
+    double base[4] = {0, 0, 0, 0};
+    for (int t : thread_counts) {
+        ws::set_num_threads(t);
+        double r[4];
+        r[0] = seconds([&] { sink += totient_range_parallel(n)[n]; });
+        r[1] = seconds([&] { sink += find_all_prime_divisor_batch(to_factor).size(); });
+        r[2] = seconds([&] {
+            ans = static_cast<ll>(1e18);
+            vector<ll> factors;
+            factorize_and_search(admission_k, factors, 2);
+            sink += ans.load();
+        });
+        r[3] = seconds([&] { sink += static_cast<long long>(totient_sum(100000000000ULL, 0, t) & 0xff); });
+        std::cout << std::setw(8) << t;
+        for (int k = 0; k < 4; ++k) {
+            if (t == 1) base[k] = r[k];
+            std::cout << std::setw(12) << std::setprecision(3) << r[k] << " (x" << std::setprecision(2) << base[k] / r[k] << ")";
+        }
+        std::cout << "\n";
+    }
+    if (sink == 42) std::cout << "";
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include "polynomial.cpp"
+
+// polynomial multiplication mod 998244353: schoolbook vs Karatsuba vs NTT, sizes 2^10 .. 2^22.
+// build: g++ -std=c++17 -O2 -mavx2 bench_polynomial_multiply.cpp   (drop -mavx2 for the scalar path)
+using poly::vec;
+constexpr uint32_t P = 998244353;
+
+vec schoolbook(const vec& a, const vec& b) {
+    std::vector<uint64_t> acc(a.size() + b.size() - 1, 0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t j = 0; j < b.size(); ++j) {
+            acc[i + j] += static_cast<uint64_t>(a[i]) * b[j] % P;
+            if (acc[i + j] >= (uint64_t(1) << 62)) acc[i + j] %= P;
+        }
+    }
+    vec r(acc.size());
+    for (size_t i = 0; i < r.size(); ++i) r[i] = static_cast<uint32_t>(acc[i] % P);
+    return r;
+}
+
+// equal power-of-two lengths n, writes 2n - 1 coefficients to r
+void karatsuba(const uint32_t* a, const uint32_t* b, int n, uint64_t* r) {
+    if (n <= 32) {
+        for (int i = 0; i < 2 * n - 1; ++i) r[i] = 0;
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j) r[i + j] = (r[i + j] + static_cast<uint64_t>(a[i]) * b[j]) % P;
+        return;
+    }
+    int h = n / 2;
+    std::vector<uint32_t> sa(h), sb(h);
+    for (int i = 0; i < h; ++i) {
+        sa[i] = (a[i] + a[i + h]) % P;
+        sb[i] = (b[i] + b[i + h]) % P;
+    }
+    std::vector<uint64_t> lo(2 * h - 1), hi(2 * h - 1), mid(2 * h - 1);
+    karatsuba(a, b, h, lo.data());
+    karatsuba(a + h, b + h, h, hi.data());
+    karatsuba(sa.data(), sb.data(), h, mid.data());
+    for (int i = 0; i < 2 * n - 1; ++i) r[i] = 0;
+    for (int i = 0; i < 2 * h - 1; ++i) {
+        r[i] = (r[i] + lo[i]) % P;
+        r[i + n] = (r[i + n] + hi[i]) % P;
+        r[i + h] = (r[i + h] + mid[i] + 2 * P - lo[i] - hi[i]) % P;
+    }
+}
+
+template <typename F>
+double ms(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    using namespace std;
+#ifdef __AVX2__
+    cout << "NTT path: AVX2\n";
+#else
+    cout << "NTT path: scalar\n";
+#endif
+    mt19937 rng(12345);
+    cout << setw(8) << "n" << setw(14) << "schoolbook" << setw(14) << "karatsuba" << setw(12) << "ntt"
+         << setw(14) << "ntt 3-prime" << "   (ms, '-' = skipped)\n" << fixed << setprecision(2);
+    for (int lg = 10; lg <= 22; ++lg) {
+        int n = 1 << lg;
+        vec a(n), b(n);
+        for (auto& x : a) x = rng() % P;
+        for (auto& x : b) x = rng() % P;
+        vec c_ntt, c_crt;
+        poly::multiply<P>(a, b);   // warm the twiddle table
+        double t_ntt = ms([&] { c_ntt = poly::multiply<P>(a, b); });
+        double t_crt = ms([&] { c_crt = poly::multiply_mod(a, b, P); });
+        if (c_crt != c_ntt) { cerr << "3-prime mismatch\n"; return 1; }
+        cout << setw(8) << n;
+        if (lg <= 16) {
+            vec c;
+            cout << setw(14) << ms([&] { c = schoolbook(a, b); });
+            if (c != c_ntt) { cerr << "schoolbook mismatch\n"; return 1; }
+        } else {
+            cout << setw(14) << "-";
+        }
+        if (lg <= 18) {
+            vector<uint64_t> r(2 * n - 1);
+            cout << setw(14) << ms([&] { karatsuba(a.data(), b.data(), n, r.data()); });
+            if (!equal(r.begin(), r.end(), c_ntt.begin())) { cerr << "karatsuba mismatch\n"; return 1; }
+        } else {
+            cout << setw(14) << "-";
+        }
+        cout << setw(12) << t_ntt << setw(14) << t_crt << "\n";
+    }
+    return 0;
+}
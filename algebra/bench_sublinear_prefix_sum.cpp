@@ -0,0 +1,40 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include "sublinear_prefix_sum.cpp"
+
+// timings of DuSieve (sum of phi, Mertens) and Lucy prime_pi at 10^9 .. 10^12.
+// build: g++ -std=c++17 -O2 -pthread bench_sublinear_prefix_sum.cpp
+using clk = std::chrono::steady_clock;
+
+template <typename F>
+double seconds(F f) {
+    auto start = clk::now();
+    f();
+    return std::chrono::duration<double>(clk::now() - start).count();
+}
+
+int main() {
+    using namespace std;
+    const int threads = max(1u, thread::hardware_concurrency());
+    cout << fixed << setprecision(3);
+    for (uint64_t n : {1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull}) {
+        for (int t : {1, threads}) {
+            u128 phi_sum = 0;
+            int64_t m = 0;
+            uint64_t pi = 0;
+            double du = seconds([&] {
+                DuSieve d(n, 0, t);
+                phi_sum = d.totient_sum(n);
+                m = d.mertens(n);
+            });
+            double lucy = seconds([&] { pi = prime_pi(n, 0, t); });
+            cout << "n = " << n << ", threads = " << t
+                 << "\n  DuSieve  " << du << " s  sum phi = " << sublinear::to_string(phi_sum) << ", M = " << m
+                 << "\n  prime_pi " << lucy << " s  pi = " << pi << "\n";
+            if (t == threads) break;
+        }
+    }
+    return 0;
+}
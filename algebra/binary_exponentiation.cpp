@@ -1,4 +1,5 @@
 #include <iostream>
+#include <stdexcept>
 
 template<typename T>
 struct BinaryOperation {
@@ -33,6 +34,8 @@ struct Multiply : BinaryOperation<int> {
     }
 };
 
+// define BINARY_EXPONENTIATION_NO_MAIN to include power() from another file
+#ifndef BINARY_EXPONENTIATION_NO_MAIN
 int main() {
     int base = 5;
     int exponent = 10;
@@ -42,4 +45,5 @@ int main() {
     std::cout << base << " raised to the power of " << exponent << " is " << result << std::endl;
     return 0;
    
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,222 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <stdexcept>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+#include "modular_arithmetic.cpp"
+#include "totient_function.cpp"
+#include "trial_divisor.cpp"
+
+// Modular binomial coefficients.
+//
+//   FactorialTable      n!, 1/n!, 1/n mod a prime p for n < p, built in O(n) with one exponentiation
+//   LucasBinomial       any n, k mod a small prime p (Lucas's theorem over a table of size p)
+//   PrimePowerBinomial  any n, k mod p^e (factorials with p removed + Legendre's formula)
+//   BinomialMod         any modulus: factorized with find_all_prime_divisor, one of the above
+//                       per prime-power factor, recombined by CRT
+
+using binom_query = std::pair<uint64_t, uint64_t>;   // (n, k)
+
+class FactorialTable {
+private:
+    uint32_t mod;
+    std::vector<uint32_t> fact;
+    std::vector<uint32_t> inv_fact;
+    std::vector<uint32_t> inv;
+
+public:
+    FactorialTable(uint32_t n, uint32_t p) : mod(p) {
+        if (p < 2) throw std::invalid_argument("FactorialTable: modulus must be a prime");
+        if (n >= p) throw std::invalid_argument("FactorialTable: n must be below the modulus");
+        fact.assign(n + 1, 1);
+        inv_fact.assign(n + 1, 1);
+        inv.assign(n + 1, 1);
+        for (uint32_t i = 1; i <= n; ++i) fact[i] = static_cast<uint32_t>(static_cast<uint64_t>(fact[i - 1]) * i % mod);
+        // the only exponentiation: 1/n!, then 1/(i-1)! = i / i! walking down
+        inv_fact[n] = static_cast<uint32_t>(mod_inverse_prime(fact[n], mod));
+        for (uint32_t i = n; i >= 1; --i) {
+            inv_fact[i - 1] = static_cast<uint32_t>(static_cast<uint64_t>(inv_fact[i]) * i % mod);
+            inv[i] = static_cast<uint32_t>(static_cast<uint64_t>(inv_fact[i]) * fact[i - 1] % mod);
+        }
+    }
+
+    uint32_t modulus() const { return mod; }
+    uint32_t size() const { return static_cast<uint32_t>(fact.size()) - 1; }
+    uint32_t factorial(uint32_t n) const { return fact.at(n); }
+    uint32_t inverse_factorial(uint32_t n) const { return inv_fact.at(n); }
+    uint32_t inverse(uint32_t i) const {
+        if (i == 0) throw std::invalid_argument("FactorialTable::inverse: zero has no inverse");
+        return inv.at(i);
+    }
+
+    // C(n, k) mod p, 0 when k > n
+    uint32_t binom(uint64_t n, uint64_t k) const {
+        if (n >= fact.size()) throw std::out_of_range("FactorialTable::binom: n exceeds the table");
+        if (k > n) return 0;
+        return static_cast<uint32_t>(static_cast<uint64_t>(fact[n]) * inv_fact[k] % mod * inv_fact[n - k] % mod);
+    }
+
+    void binom_batch(const binom_query* queries, size_t count, uint32_t* out) const {
+        const uint64_t limit = fact.size();
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t n = queries[i].first, k = queries[i].second;
+            if (n >= limit) throw std::out_of_range("FactorialTable::binom: n exceeds the table");
+            out[i] = k > n ? 0 : static_cast<uint32_t>(static_cast<uint64_t>(fact[n]) * inv_fact[k] % mod * inv_fact[n - k] % mod);
+        }
+    }
+
+#if __cplusplus >= 202002L
+    std::vector<uint32_t> binom(std::span<const binom_query> queries) const {
+        std::vector<uint32_t> out(queries.size());
+        binom_batch(queries.data(), queries.size(), out.data());
+        return out;
+    }
+#endif
+};
+
+// one prime-power factor of a BinomialMod modulus
+struct BinomialComponent {
+    virtual uint32_t binom(uint64_t n, uint64_t k) const = 0;
+    virtual ~BinomialComponent() = default;
+};
+
+// C(n, k) mod p = prod C(n_i, k_i) over the base-p digits of n and k
+class LucasBinomial : public BinomialComponent {
+private:
+    uint32_t p;
+    FactorialTable table;
+
+public:
+    explicit LucasBinomial(uint32_t prime) : p(prime), table(prime - 1, prime) {}
+
+    uint32_t binom(uint64_t n, uint64_t k) const override {
+        uint64_t res = 1;
+        while ((n > 0 || k > 0) && res != 0) {
+            uint64_t ni = n % p, ki = k % p;
+            if (ki > ni) return 0;
+            res = res * table.binom(ni, ki) % p;
+            n /= p;
+            k /= p;
+        }
+        return static_cast<uint32_t>(res);
+    }
+};
+
+// C(n, k) mod p^e: n! = p^{v_p(n!)} * n!_p where n!_p drops every factor p,
+// and n!_p = (prod of units below p^e)^{n / p^e} * coprime[n mod p^e] * (n / p)!_p
+class PrimePowerBinomial : public BinomialComponent {
+private:
+    uint64_t p;
+    int e;
+    uint64_t pe;
+    std::vector<uint32_t> coprime;   // coprime[i] = product of j <= i with p not dividing j, mod p^e
+
+    uint64_t factorial_without_p(uint64_t n) const {
+        uint64_t res = 1;
+        while (n > 0) {
+            res = res * mod_pow(coprime[pe - 1], n / pe, pe) % pe * coprime[n % pe] % pe;
+            n /= p;
+        }
+        return res;
+    }
+
+    uint64_t legendre(uint64_t n) const {
+        uint64_t v = 0;
+        while (n > 0) {
+            n /= p;
+            v += n;
+        }
+        return v;
+    }
+
+public:
+    PrimePowerBinomial(uint64_t prime, int exponent) : p(prime), e(exponent), pe(1) {
+        for (int i = 0; i < e; ++i) pe *= p;
+        coprime.assign(pe, 1);
+        for (uint64_t i = 1; i < pe; ++i) {
+            coprime[i] = static_cast<uint32_t>(i % p == 0 ? coprime[i - 1] : coprime[i - 1] * i % pe);
+        }
+    }
+
+    uint32_t binom(uint64_t n, uint64_t k) const override {
+        if (k > n) return 0;
+        uint64_t v = legendre(n) - legendre(k) - legendre(n - k);
+        if (v >= static_cast<uint64_t>(e)) return 0;
+        uint64_t den = factorial_without_p(k) * factorial_without_p(n - k) % pe;
+        uint64_t res = factorial_without_p(n) * mod_inverse(den, pe) % pe;
+        for (uint64_t i = 0; i < v; ++i) res = res * p % pe;
+        return static_cast<uint32_t>(res);
+    }
+};
+
+// wraps a FactorialTable for a large prime factor when every n stays below it
+class TableBinomial : public BinomialComponent {
+private:
+    FactorialTable table;
+public:
+    TableBinomial(uint32_t max_n, uint32_t p) : table(max_n, p) {}
+    uint32_t binom(uint64_t n, uint64_t k) const override { return table.binom(n, k); }
+};
+
+class BinomialMod {
+private:
+    uint32_t mod;
+    std::vector<std::unique_ptr<BinomialComponent>> parts;
+    std::vector<uint64_t> part_mod;
+    std::vector<uint64_t> crt_coef;   // (mod / m_i) * ((mod / m_i)^{-1} mod m_i), mod `mod`
+
+public:
+    // largest table a single prime-power factor may allocate
+    static constexpr uint64_t MAX_TABLE = uint64_t(1) << 26;
+
+    // prime factors above max_n use a factorial table, so those moduli need n <= max_n;
+    // Lucas and prime-power factors accept any n
+    BinomialMod(uint32_t m, uint64_t max_n) : mod(m) {
+        if (m < 1 || m > static_cast<uint32_t>(INT32_MAX)) throw std::invalid_argument("BinomialMod: modulus must be in [1, 2^31)");
+        for (const auto& [prime, exponent] : find_all_prime_divisor(static_cast<int>(m))) {
+            uint64_t pe = 1;
+            for (int i = 0; i < exponent; ++i) pe *= prime;
+            if (exponent == 1 && max_n < static_cast<uint64_t>(prime)) {
+                parts.emplace_back(new TableBinomial(static_cast<uint32_t>(max_n), prime));
+            } else if (pe > MAX_TABLE) {
+                throw std::invalid_argument("BinomialMod: prime-power factor too large for its table");
+            } else if (exponent == 1) {
+                parts.emplace_back(new LucasBinomial(prime));
+            } else {
+                parts.emplace_back(new PrimePowerBinomial(prime, exponent));
+            }
+            part_mod.push_back(pe);
+            // Euler: (m / pe)^{-1} = (m / pe)^{phi(pe) - 1} mod pe
+            uint64_t rest = m / pe;
+            uint64_t inv = mod_pow(rest % pe, static_cast<uint64_t>(totient_single(static_cast<int>(pe))) - 1, pe);
+            crt_coef.push_back(rest * inv % m);
+        }
+    }
+
+    uint32_t modulus() const { return mod; }
+
+    uint32_t binom(uint64_t n, uint64_t k) const {
+        if (mod == 1 || k > n) return 0;
+        uint64_t res = 0;
+        for (size_t i = 0; i < parts.size(); ++i) {
+            res = (res + parts[i]->binom(n, k) * crt_coef[i]) % mod;
+        }
+        return static_cast<uint32_t>(res);
+    }
+
+    void binom_batch(const binom_query* queries, size_t count, uint32_t* out) const {
+        for (size_t i = 0; i < count; ++i) out[i] = binom(queries[i].first, queries[i].second);
+    }
+
+#if __cplusplus >= 202002L
+    std::vector<uint32_t> binom(std::span<const binom_query> queries) const {
+        std::vector<uint32_t> out(queries.size());
+        binom_batch(queries.data(), queries.size(), out.data());
+        return out;
+    }
+#endif
+};
@@ -0,0 +1,174 @@
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <stdexcept>
+
+// Generic linear (Euler) sieve for multiplicative and additive arithmetic functions.
+//
+// A function f is described by a policy with:
+//   value_type                          storage type of one value
+//   identity()                          f(1), and the neutral element of combine
+//   combine(a, b)                       f(a*b) from f(a), f(b) for coprime a, b (a*b or a+b usually)
+//   at_prime_power(p, e, pk)            f(p^e), with pk == p^e
+//
+// Every i = m * p^e with p the smallest prime factor and gcd(m, p) = 1 is written exactly once
+// as combine(f(m), f(p^e)); all requested functions are filled in the same pass and each one
+// lives in its own array (structure of arrays), so the per-field width is the policy's choice.
+
+namespace sieve_policy {
+
+// Euler's phi, fits uint32_t for n < 2^32
+struct Phi {
+    using value_type = uint32_t;
+    static value_type identity() { return 1; }
+    static value_type combine(value_type a, value_type b) { return a * b; }
+    static value_type at_prime_power(uint64_t p, int, uint64_t pk) { return static_cast<value_type>(pk / p * (p - 1)); }
+};
+
+// Moebius mu in {-1, 0, 1}
+struct Mobius {
+    using value_type = int8_t;
+    static value_type identity() { return 1; }
+    static value_type combine(value_type a, value_type b) { return static_cast<value_type>(a * b); }
+    static value_type at_prime_power(uint64_t, int e, uint64_t) { return e == 1 ? -1 : 0; }
+};
+
+// number of divisors d(n), at most 1344 for n < 2^32
+struct DivisorCount {
+    using value_type = uint16_t;
+    static value_type identity() { return 1; }
+    static value_type combine(value_type a, value_type b) { return static_cast<value_type>(a * b); }
+    static value_type at_prime_power(uint64_t, int e, uint64_t) { return static_cast<value_type>(e + 1); }
+};
+
+// sum of divisors sigma(n)
+struct DivisorSum {
+    using value_type = uint64_t;
+    static value_type identity() { return 1; }
+    static value_type combine(value_type a, value_type b) { return a * b; }
+    static value_type at_prime_power(uint64_t p, int, uint64_t pk) { return (pk * p - 1) / (p - 1); }
+};
+
+// number of distinct prime factors omega(n), additive
+struct Omega {
+    using value_type = uint8_t;
+    static value_type identity() { return 0; }
+    static value_type combine(value_type a, value_type b) { return static_cast<value_type>(a + b); }
+    static value_type at_prime_power(uint64_t, int, uint64_t) { return 1; }
+};
+
+// smallest prime factor, 0 for n == 1 ("no prime factor")
+struct SmallestPrimeFactor {
+    using value_type = uint32_t;
+    static value_type identity() { return 0; }
+    static value_type combine(value_type a, value_type b) {
+        if (a == 0) return b;
+        if (b == 0) return a;
+        return a < b ? a : b;
+    }
+    static value_type at_prime_power(uint64_t p, int, uint64_t) { return static_cast<value_type>(p); }
+};
+
+} // namespace sieve_policy
+
+// position of P inside Ps...
+template <typename P, typename... Ps>
+struct policy_index;
+template <typename P, typename... Ps>
+struct policy_index<P, P, Ps...> : std::integral_constant<size_t, 0> {};
+template <typename P, typename Q, typename... Ps>
+struct policy_index<P, Q, Ps...> : std::integral_constant<size_t, 1 + policy_index<P, Ps...>::value> {};
+
+template <typename... Policies>
+class LinearSieve {
+private:
+    uint32_t n;
+    uint32_t num_primes = 0;
+    std::unique_ptr<uint32_t[]> prime_list;
+    size_t prime_capacity = 0;
+    std::tuple<std::unique_ptr<typename Policies::value_type[]>...> fields;
+
+    // Rosser-Schoenfeld: pi(x) < 1.25506 x / ln x for x > 1
+    static size_t prime_count_upper_bound(uint32_t x) {
+        if (x < 17) return 7;
+        return static_cast<size_t>(1.25506 * x / std::log(static_cast<double>(x))) + 1;
+    }
+
+    template <typename P>
+    typename P::value_type* field() {
+        return std::get<policy_index<P, Policies...>::value>(fields).get();
+    }
+
+    template <typename P>
+    void set_prime_power(uint32_t target, uint32_t m, uint64_t p, int e, uint64_t pk) {
+        auto* f = field<P>();
+        f[target] = P::combine(f[m], P::at_prime_power(p, e, pk));
+    }
+
+public:
+    explicit LinearSieve(uint32_t limit) : n(limit) {
+        if (n < 1) throw std::invalid_argument("Input must be a positive integer.");
+        if (n == UINT32_MAX) throw std::invalid_argument("LinearSieve: limit must be below 2^32 - 1");
+        prime_capacity = prime_count_upper_bound(n);
+        prime_list.reset(new uint32_t[prime_capacity]);
+        fields = std::make_tuple(std::unique_ptr<typename Policies::value_type[]>(new typename Policies::value_type[n + 1])...);
+        (void(field<Policies>()[0] = typename Policies::value_type{}), ...);
+        (void(field<Policies>()[1] = Policies::identity()), ...);
+
+        // 1 bit per number; the values themselves cannot mark primes (e.g. Omega, Mobius repeat)
+        std::unique_ptr<uint64_t[]> composite(new uint64_t[(n >> 6) + 1]());
+
+        for (uint32_t i = 2; i <= n; ++i) {
+            if (!((composite[i >> 6] >> (i & 63)) & 1)) {
+                prime_list[num_primes++] = i;
+                (set_prime_power<Policies>(i, 1, i, 1, i), ...);
+            }
+            for (uint32_t j = 0; j < num_primes; ++j) {
+                uint32_t p = prime_list[j];
+                uint64_t ip64 = static_cast<uint64_t>(i) * p;
+                if (ip64 > n) break;
+                uint32_t ip = static_cast<uint32_t>(ip64);
+                composite[ip >> 6] |= uint64_t(1) << (ip & 63);
+                if (i % p == 0) {
+                    // ip = m * p^e with gcd(m, p) = 1
+                    uint32_t m = i / p;
+                    int e = 2;
+                    uint64_t pk = static_cast<uint64_t>(p) * p;
+                    while (m % p == 0) {
+                        m /= p;
+                        ++e;
+                        pk *= p;
+                    }
+                    (set_prime_power<Policies>(ip, m, p, e, pk), ...);
+                    break;
+                }
+                (set_prime_power<Policies>(ip, i, p, 1, p), ...);
+            }
+        }
+    }
+
+    uint32_t limit() const { return n; }
+
+    // f(0..n) for policy P; f(0) is value_type{}
+    template <typename P>
+    const typename P::value_type* values() const {
+        return std::get<policy_index<P, Policies...>::value>(fields).get();
+    }
+
+    template <typename P>
+    typename P::value_type at(uint32_t i) const {
+        if (i > n) throw std::out_of_range("LinearSieve::at: index out of range");
+        return values<P>()[i];
+    }
+
+    const uint32_t* primes() const { return prime_list.get(); }
+    uint32_t prime_count() const { return num_primes; }
+
+    // bytes held after construction (the composite bitmap is released)
+    size_t memory_bytes() const {
+        return prime_capacity * sizeof(uint32_t) + ((sizeof(typename Policies::value_type) * (size_t(n) + 1)) + ... + 0);
+    }
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#define BINARY_EXPONENTIATION_NO_MAIN
+#include "binary_exponentiation.cpp"
+
+// modular multiplication as a BinaryOperation, so power() computes a^e mod m
+struct ModMultiply : BinaryOperation<uint64_t> {
+    uint64_t mod;
+    explicit ModMultiply(uint64_t m) : mod(m) {}
+    uint64_t operator()(uint64_t a, uint64_t b) const override {
+        return static_cast<uint64_t>(static_cast<unsigned __int128>(a) * b % mod);
+    }
+};
+
+// a^e mod m, e >= 0
+inline uint64_t mod_pow(uint64_t a, uint64_t e, uint64_t m) {
+    if (m == 1) return 0;
+    if (e == 0) return 1;
+    if (e > static_cast<uint64_t>(INT32_MAX)) {
+        // power() takes an int exponent: split e = hi * 2^30 + lo
+        uint64_t hi = mod_pow(mod_pow(a, e >> 30, m), uint64_t(1) << 30, m);
+        return ModMultiply(m)(hi, mod_pow(a, e & ((uint64_t(1) << 30) - 1), m));
+    }
+    return power<uint64_t>(a % m, static_cast<int>(e), 1, ModMultiply(m));
+}
+
+// inverse of a modulo a prime p by Fermat's little theorem
+inline uint64_t mod_inverse_prime(uint64_t a, uint64_t p) {
+    if (a % p == 0) throw std::invalid_argument("mod_inverse_prime: a is divisible by p");
+    return mod_pow(a, p - 2, p);
+}
+
+// inverse of a modulo any m with gcd(a, m) = 1, by the extended Euclidean algorithm
+inline uint64_t mod_inverse(uint64_t a, uint64_t m) {
+    int64_t old_r = static_cast<int64_t>(a % m), r = static_cast<int64_t>(m);
+    int64_t old_s = 1, s = 0;
+    while (r != 0) {
+        int64_t q = old_r / r;
+        int64_t t = old_r - q * r; old_r = r; r = t;
+        t = old_s - q * s; old_s = s; s = t;
+    }
+    if (old_r != 1) throw std::invalid_argument("mod_inverse: a is not invertible modulo m");
+    return static_cast<uint64_t>(old_s < 0 ? old_s + static_cast<int64_t>(m) : old_s) % m;
+}
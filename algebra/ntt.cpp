@@ -0,0 +1,266 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "modular_arithmetic.cpp"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Montgomery arithmetic modulo an odd MOD < 2^30, values kept in [0, MOD).
+// reduce(t) = t / 2^32 mod MOD, computed as hi(t) - hi(m * MOD) with m = lo(t) * MOD^{-1},
+// which never overflows and needs one conditional add.
+template <uint32_t MOD>
+struct Montgomery {
+    static_assert(MOD % 2 == 1 && MOD < (1u << 30), "Montgomery: MOD must be odd and below 2^30");
+
+    static constexpr uint32_t mod_inv() {
+        uint32_t x = MOD;   // correct to 3 bits, each Newton step doubles that
+        for (int i = 0; i < 4; ++i) x *= 2 - MOD * x;
+        return x;
+    }
+    static constexpr uint32_t INV = mod_inv();                                                   // MOD^{-1} mod 2^32
+    static constexpr uint32_t R2 = static_cast<uint32_t>((static_cast<unsigned __int128>(1) << 64) % MOD);  // 2^64 mod MOD
+
+    static uint32_t reduce(uint64_t t) {
+        uint32_t m = static_cast<uint32_t>(t) * INV;
+        int64_t r = static_cast<int64_t>(t >> 32) - static_cast<int64_t>((static_cast<uint64_t>(m) * MOD) >> 32);
+        return static_cast<uint32_t>(r < 0 ? r + MOD : r);
+    }
+    static uint32_t mul(uint32_t a, uint32_t b) { return reduce(static_cast<uint64_t>(a) * b); }
+    static uint32_t add(uint32_t a, uint32_t b) { uint32_t r = a + b; return r >= MOD ? r - MOD : r; }
+    static uint32_t sub(uint32_t a, uint32_t b) { return a >= b ? a - b : a + MOD - b; }
+    static uint32_t to(uint32_t x) { return mul(x, R2); }
+    static uint32_t from(uint32_t x) { return reduce(x); }
+};
+
+// one lane per step
+template <uint32_t MOD>
+struct ScalarLane {
+    using M = Montgomery<MOD>;
+    using type = uint32_t;
+    static constexpr int width = 1;
+    static type load(const uint32_t* p) { return *p; }
+    static void store(uint32_t* p, type x) { *p = x; }
+    static type add(type a, type b) { return M::add(a, b); }
+    static type sub(type a, type b) { return M::sub(a, b); }
+    static type mul(type a, type b) { return M::mul(a, b); }
+};
+
+#ifdef __AVX2__
+// eight lanes per step, same reduction as Montgomery::reduce on even/odd halves
+template <uint32_t MOD>
+struct Avx2Lane {
+    using M = Montgomery<MOD>;
+    using type = __m256i;
+    static constexpr int width = 8;
+    static type load(const uint32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(uint32_t* p, type x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+    static type add(type a, type b) {
+        const __m256i mod = _mm256_set1_epi32(MOD);
+        __m256i r = _mm256_add_epi32(a, b);
+        return _mm256_min_epu32(r, _mm256_sub_epi32(r, mod));
+    }
+    static type sub(type a, type b) {
+        const __m256i mod = _mm256_set1_epi32(MOD);
+        __m256i r = _mm256_sub_epi32(a, b);
+        return _mm256_min_epu32(r, _mm256_add_epi32(r, mod));
+    }
+    static type mul(type a, type b) {
+        const __m256i mod = _mm256_set1_epi32(MOD);
+        const __m256i inv = _mm256_set1_epi32(static_cast<int>(M::INV));
+        __m256i te = _mm256_mul_epu32(a, b);
+        __m256i to = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+        __m256i pe = _mm256_mul_epu32(_mm256_mul_epu32(te, inv), mod);
+        __m256i po = _mm256_mul_epu32(_mm256_mul_epu32(to, inv), mod);
+        __m256i thi = _mm256_blend_epi32(_mm256_srli_epi64(te, 32), to, 0xAA);
+        __m256i phi = _mm256_blend_epi32(_mm256_srli_epi64(pe, 32), po, 0xAA);
+        __m256i r = _mm256_sub_epi32(thi, phi);
+        return _mm256_min_epu32(r, _mm256_add_epi32(r, mod));
+    }
+};
+#endif
+
+// NTT over Z/MOD with primitive root G.
+// forward() is a decimation-in-frequency transform (natural order in, bit-reversed out) and
+// inverse() the matching decimation-in-time one, so convolutions never permute.
+// Levels are fused in pairs (radix-4 passes over memory); levels whose blocks fit in BLOCK
+// elements are finished block by block so they run out of cache.
+template <uint32_t MOD, uint32_t G = 3>
+class NTT {
+private:
+    using M = Montgomery<MOD>;
+    static constexpr int BLOCK = 1 << 12;
+    std::vector<uint32_t> rt;    // rt[h + j] = w_{2h}^j (Montgomery form), w_{2h} a primitive 2h-th root
+    std::vector<uint32_t> irt;   // same for w_{2h}^{-1}
+    int max_n = 1;
+
+    template <typename V>
+    static void dif2(uint32_t* a, int len, int h, const uint32_t* tw) {
+        for (int s = 0; s < len; s += 2 * h) {
+            for (int j = 0; j < h; j += V::width) {
+                auto u = V::load(a + s + j), v = V::load(a + s + j + h);
+                V::store(a + s + j, V::add(u, v));
+                V::store(a + s + j + h, V::mul(V::sub(u, v), V::load(tw + h + j)));
+            }
+        }
+    }
+
+    // levels with half-size h and h/2 in one pass
+    template <typename V>
+    static void dif4(uint32_t* a, int len, int h, const uint32_t* tw) {
+        int q = h / 2;
+        for (int s = 0; s < len; s += 2 * h) {
+            for (int j = 0; j < q; j += V::width) {
+                auto x0 = V::load(a + s + j), x1 = V::load(a + s + j + q);
+                auto x2 = V::load(a + s + j + h), x3 = V::load(a + s + j + h + q);
+                auto y0 = V::add(x0, x2), y2 = V::mul(V::sub(x0, x2), V::load(tw + h + j));
+                auto y1 = V::add(x1, x3), y3 = V::mul(V::sub(x1, x3), V::load(tw + h + j + q));
+                auto w = V::load(tw + q + j);
+                V::store(a + s + j, V::add(y0, y1));
+                V::store(a + s + j + q, V::mul(V::sub(y0, y1), w));
+                V::store(a + s + j + h, V::add(y2, y3));
+                V::store(a + s + j + h + q, V::mul(V::sub(y2, y3), w));
+            }
+        }
+    }
+
+    template <typename V>
+    static void dit2(uint32_t* a, int len, int h, const uint32_t* tw) {
+        for (int s = 0; s < len; s += 2 * h) {
+            for (int j = 0; j < h; j += V::width) {
+                auto u = V::load(a + s + j), v = V::mul(V::load(a + s + j + h), V::load(tw + h + j));
+                V::store(a + s + j, V::add(u, v));
+                V::store(a + s + j + h, V::sub(u, v));
+            }
+        }
+    }
+
+    // levels with half-size h and 2h in one pass
+    template <typename V>
+    static void dit4(uint32_t* a, int len, int h, const uint32_t* tw) {
+        for (int s = 0; s < len; s += 4 * h) {
+            for (int j = 0; j < h; j += V::width) {
+                auto w = V::load(tw + h + j);
+                auto x0 = V::load(a + s + j), x1 = V::mul(V::load(a + s + j + h), w);
+                auto x2 = V::load(a + s + j + 2 * h), x3 = V::mul(V::load(a + s + j + 3 * h), w);
+                auto y0 = V::add(x0, x1), y1 = V::sub(x0, x1);
+                auto y2 = V::mul(V::add(x2, x3), V::load(tw + 2 * h + j));
+                auto y3 = V::mul(V::sub(x2, x3), V::load(tw + 3 * h + j));
+                V::store(a + s + j, V::add(y0, y2));
+                V::store(a + s + j + 2 * h, V::sub(y0, y2));
+                V::store(a + s + j + h, V::add(y1, y3));
+                V::store(a + s + j + 3 * h, V::sub(y1, y3));
+            }
+        }
+    }
+
+    // pick the widest lane that divides the inner loop
+#ifdef __AVX2__
+#define NTT_DISPATCH(kernel, inner, ...) \
+    ((inner) % 8 == 0 ? kernel<Avx2Lane<MOD>>(__VA_ARGS__) : kernel<ScalarLane<MOD>>(__VA_ARGS__))
+#else
+#define NTT_DISPATCH(kernel, inner, ...) kernel<ScalarLane<MOD>>(__VA_ARGS__)
+#endif
+
+    // DIF levels with half-size h, h/2, ... while > h_stop
+    void dif_run(uint32_t* a, int len, int h, int h_stop) const {
+        while (h > h_stop) {
+            if (h / 2 > h_stop) {
+                NTT_DISPATCH(dif4, h / 2, a, len, h, rt.data());
+                h >>= 2;
+            } else {
+                NTT_DISPATCH(dif2, h, a, len, h, rt.data());
+                h >>= 1;
+            }
+        }
+    }
+
+    // DIT levels with half-size h, 2h, ... while < h_stop
+    void dit_run(uint32_t* a, int len, int h, int h_stop) const {
+        while (h < h_stop) {
+            if (2 * h < h_stop) {
+                NTT_DISPATCH(dit4, h, a, len, h, irt.data());
+                h <<= 2;
+            } else {
+                NTT_DISPATCH(dit2, h, a, len, h, irt.data());
+                h <<= 1;
+            }
+        }
+    }
+#undef NTT_DISPATCH
+
+public:
+    NTT() = default;
+
+    // grow the twiddle tables to transforms of length n (a power of two dividing MOD - 1)
+    void ensure(int n) {
+        if (n <= max_n) return;
+        if (n & (n - 1)) throw std::invalid_argument("NTT: length must be a power of two");
+        if ((MOD - 1) % n != 0) throw std::invalid_argument("NTT: length does not divide MOD - 1");
+        rt.assign(n, 0);
+        irt.assign(n, 0);
+        for (int h = 1; h < n; h <<= 1) {
+            uint32_t w = static_cast<uint32_t>(mod_pow(G, (MOD - 1) / (2 * h), MOD));
+            uint32_t iw = static_cast<uint32_t>(mod_inverse_prime(w, MOD));
+            uint32_t wm = M::to(w), iwm = M::to(iw), cur = M::to(1), icur = M::to(1);
+            for (int j = 0; j < h; ++j) {
+                rt[h + j] = cur;
+                irt[h + j] = icur;
+                cur = M::mul(cur, wm);
+                icur = M::mul(icur, iwm);
+            }
+        }
+        max_n = n;
+    }
+
+    // in place, Montgomery form, natural order in, bit-reversed order out
+    void forward(uint32_t* a, int n) {
+        ensure(n);
+        if (n > BLOCK) {
+            dif_run(a, n, n / 2, BLOCK / 2);
+            for (int s = 0; s < n; s += BLOCK) dif_run(a + s, BLOCK, BLOCK / 2, 0);
+        } else {
+            dif_run(a, n, n / 2, 0);
+        }
+    }
+
+    // in place, Montgomery form, bit-reversed order in, natural order out, scaled by 1/n
+    void inverse(uint32_t* a, int n) {
+        ensure(n);
+        if (n > BLOCK) {
+            for (int s = 0; s < n; s += BLOCK) dit_run(a + s, BLOCK, 1, BLOCK);
+            dit_run(a, n, BLOCK, n);
+        } else {
+            dit_run(a, n, 1, n);
+        }
+        uint32_t inv_n = M::to(static_cast<uint32_t>(mod_inverse_prime(n, MOD)));
+        for (int i = 0; i < n; ++i) a[i] = M::mul(a[i], inv_n);
+    }
+
+    // a * b, coefficients in [0, MOD), standard (non-Montgomery) form
+    std::vector<uint32_t> multiply(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+        if (a.empty() || b.empty()) return {};
+        size_t need = a.size() + b.size() - 1;
+        if (std::min(a.size(), b.size()) <= 32) {
+            std::vector<uint64_t> acc(need, 0);
+            for (size_t i = 0; i < a.size(); ++i) {
+                for (size_t j = 0; j < b.size(); ++j) acc[i + j] = (acc[i + j] + static_cast<uint64_t>(a[i]) * b[j]) % MOD;
+            }
+            return std::vector<uint32_t>(acc.begin(), acc.end());
+        }
+        int n = 1;
+        while (static_cast<size_t>(n) < need) n <<= 1;
+        std::vector<uint32_t> fa(n, 0), fb(n, 0);
+        for (size_t i = 0; i < a.size(); ++i) fa[i] = M::to(a[i]);
+        for (size_t i = 0; i < b.size(); ++i) fb[i] = M::to(b[i]);
+        forward(fa.data(), n);
+        forward(fb.data(), n);
+        for (int i = 0; i < n; ++i) fa[i] = M::mul(fa[i], fb[i]);
+        inverse(fa.data(), n);
+        fa.resize(need);
+        for (auto& x : fa) x = M::from(x);
+        return fa;
+    }
+};
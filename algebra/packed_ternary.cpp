@@ -0,0 +1,320 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#define BALANCE_TERNARY_NO_MAIN
+#include "balance_ternary.cpp"
+
+// Packed balanced ternary: 2 bits per trit, 32 trits per uint64_t word.
+//
+// Word layout is two bit planes: the low 32 bits flag the +1 trits, the high 32 bits the -1
+// trits (trit i of the word is bit i of each plane; both clear means 0, both set never occurs).
+// Words are little-endian: word k holds trits 32k .. 32k + 31.
+//
+// Negation swaps the planes (one rotate per word). Addition is word-parallel: balanced carries
+// take three values, but a + b = (a + b + K) - K with K = ...111 splits the sum into two passes
+// whose carries are binary, so each pass resolves a whole word with one integer add of its
+// generate / propagate masks. Only the carry between words is sequential.
+//
+// The ternary_* functions work in place on raw word arrays of one fixed width (results wrap
+// modulo 3^(32 words) and the final carry is returned); PackedTernary grows as needed.
+
+namespace packed_ternary_detail {
+
+inline uint32_t plus_plane(uint64_t w) { return static_cast<uint32_t>(w); }
+inline uint32_t minus_plane(uint64_t w) { return static_cast<uint32_t>(w >> 32); }
+inline uint64_t pack(uint32_t p, uint32_t n) { return p | static_cast<uint64_t>(n) << 32; }
+
+// trit-wise sum modulo 3, balanced: no carries
+inline void digit_add(uint32_t xp, uint32_t xn, uint32_t yp, uint32_t yn, uint32_t& op, uint32_t& on) {
+    uint32_t zx = ~(xp | xn), zy = ~(yp | yn);
+    op = (xp & zy) | (yp & zx) | (xn & yn);
+    on = (xn & zy) | (yn & zx) | (xp & yp);
+}
+
+// carries pending between words: a + b + K is summed with carries in {0, 1} (up), then K is
+// taken away with borrows in {0, 1} (down); K = ...111. The net carry is up - down.
+struct Carry {
+    uint32_t up = 0, down = 0;
+};
+
+// one word of a + b + carry; returns the word and leaves the carry out in c
+inline uint64_t add_word(uint64_t a, uint64_t b, Carry& c) {
+    uint32_t ap = plus_plane(a), an = minus_plane(a), bp = plus_plane(b), bn = minus_plane(b);
+    uint32_t hp, hn;
+    digit_add(ap, an, bp, bn, hp, hn);
+    // a + b + 1 in [-1, 3] plus carry: generates for a + b >= 1, propagates for a + b = 0,
+    // so the carry into every trit falls out of one binary add of the masks
+    uint32_t g = (ap & ~bn) | (bp & ~an);
+    uint32_t x = g | ~(ap | an | bp | bn) | (ap & bn) | (an & bp);
+    uint64_t sum = static_cast<uint64_t>(x) + g + c.up;
+    uint32_t in = static_cast<uint32_t>(sum) ^ x ^ g;
+    c.up = static_cast<uint32_t>(sum >> 32);
+    uint32_t dp, dn;
+    digit_add(hp, hn, ~in, in, dp, dn);   // + 1 + carry, modulo 3
+    // d - 1 in [-2, 0] minus borrow: generates for d = -1, propagates for d = 0
+    g = dn;
+    x = g | ~(dp | dn);
+    sum = static_cast<uint64_t>(x) + g + c.down;
+    in = static_cast<uint32_t>(sum) ^ x ^ g;
+    c.down = static_cast<uint32_t>(sum >> 32);
+    uint32_t rp, rn;
+    digit_add(dp, dn, in, ~in, rp, rn);   // - 1 - borrow, modulo 3
+    return pack(rp, rn);
+}
+
+inline uint64_t negate_word(uint64_t w) { return w << 32 | w >> 32; }
+
+} // namespace packed_ternary_detail
+
+// dst = a + b + carry_in over `words` words; returns the carry out (-1, 0, 1). dst may alias a or b.
+inline int ternary_add(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t words, int carry_in = 0) {
+    packed_ternary_detail::Carry carry;
+    carry.up = carry_in > 0;
+    carry.down = carry_in < 0;
+    for (size_t i = 0; i < words; ++i) dst[i] = packed_ternary_detail::add_word(a[i], b[i], carry);
+    return static_cast<int>(carry.up) - static_cast<int>(carry.down);
+}
+
+// dst = a - b; returns the carry out
+inline int ternary_sub(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t words) {
+    packed_ternary_detail::Carry carry;
+    for (size_t i = 0; i < words; ++i) {
+        dst[i] = packed_ternary_detail::add_word(a[i], packed_ternary_detail::negate_word(b[i]), carry);
+    }
+    return static_cast<int>(carry.up) - static_cast<int>(carry.down);
+}
+
+inline void ternary_negate(uint64_t* w, size_t words) {
+    for (size_t i = 0; i < words; ++i) w[i] = packed_ternary_detail::negate_word(w[i]);
+}
+
+// sign of a - b: the highest trit where they differ decides
+inline int ternary_compare(const uint64_t* a, const uint64_t* b, size_t words) {
+    using namespace packed_ternary_detail;
+    for (size_t i = words; i-- > 0;) {
+        uint64_t d = a[i] ^ b[i];
+        if (d == 0) continue;
+        uint32_t diff = plus_plane(d) | minus_plane(d);
+        uint32_t bit = 1u << (31 - __builtin_clz(diff));
+        int ta = (plus_plane(a[i]) & bit) ? 1 : (minus_plane(a[i]) & bit) ? -1 : 0;
+        int tb = (plus_plane(b[i]) & bit) ? 1 : (minus_plane(b[i]) & bit) ? -1 : 0;
+        return ta < tb ? -1 : 1;
+    }
+    return 0;
+}
+
+// trit-wise minimum / maximum
+inline void ternary_tritwise_min(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t words) {
+    using namespace packed_ternary_detail;
+    for (size_t i = 0; i < words; ++i) {
+        dst[i] = pack(plus_plane(a[i]) & plus_plane(b[i]), minus_plane(a[i]) | minus_plane(b[i]));
+    }
+}
+
+inline void ternary_tritwise_max(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t words) {
+    using namespace packed_ternary_detail;
+    for (size_t i = 0; i < words; ++i) {
+        dst[i] = pack(plus_plane(a[i]) | plus_plane(b[i]), minus_plane(a[i]) & minus_plane(b[i]));
+    }
+}
+
+// arbitrary-width balanced-ternary integer on the packed representation
+class PackedTernary {
+public:
+    static constexpr int TRITS_PER_WORD = 32;
+
+private:
+    std::vector<uint64_t> w;   // no zero words on top; zero is empty
+
+    void trim() {
+        while (!w.empty() && w.back() == 0) w.pop_back();
+    }
+
+    // w[offset ..] += sign * b (sign = +-1), growing as needed
+    void add_at(const uint64_t* b, size_t len, size_t offset, int sign) {
+        using namespace packed_ternary_detail;
+        if (w.size() < offset + len) w.resize(offset + len, 0);
+        Carry carry;
+        for (size_t i = 0; i < len; ++i) {
+            w[offset + i] = add_word(w[offset + i], sign > 0 ? b[i] : negate_word(b[i]), carry);
+        }
+        // the rest of the sum is (up - down) * 3^k
+        for (size_t k = offset + len; carry.up != carry.down; ++k) {
+            if (k == w.size()) w.push_back(0);
+            w[k] = add_word(w[k], 0, carry);
+        }
+    }
+
+public:
+    PackedTernary() = default;
+
+    PackedTernary(int64_t v) {
+        // digits of |v| with remainder 2 becoming -1 and a carry; negate at the end
+        uint64_t m = v < 0 ? 0 - static_cast<uint64_t>(v) : static_cast<uint64_t>(v);
+        for (int i = 0; m > 0; ++i) {
+            uint64_t r = m % 3;
+            m /= 3;
+            if (r == 2) ++m;
+            if (r == 0) continue;
+            if (static_cast<size_t>(i / TRITS_PER_WORD) >= w.size()) w.resize(i / TRITS_PER_WORD + 1, 0);
+            int bit = i % TRITS_PER_WORD;
+            w[i / TRITS_PER_WORD] |= r == 1 ? uint64_t(1) << bit : uint64_t(1) << (bit + 32);
+        }
+        if (v < 0) negate();
+    }
+
+    // '1', '0', 'z' (for -1), most significant first, as produced by dec2ter
+    static PackedTernary from_chars(const bTernary& s) {
+        PackedTernary r;
+        r.w.assign((s.size() + TRITS_PER_WORD - 1) / TRITS_PER_WORD, 0);
+        for (size_t i = 0; i < s.size(); ++i) {
+            size_t pos = s.size() - 1 - i;
+            int bit = static_cast<int>(pos % TRITS_PER_WORD);
+            char c = s[i];
+            if (c == '1') r.w[pos / TRITS_PER_WORD] |= uint64_t(1) << bit;
+            else if (c == 'z') r.w[pos / TRITS_PER_WORD] |= uint64_t(1) << (bit + 32);
+            else if (c != '0') throw std::invalid_argument("PackedTernary::from_chars: trits must be '1', '0' or 'z'");
+        }
+        r.trim();
+        return r;
+    }
+
+    // empty for zero, like dec2ter
+    bTernary to_chars() const {
+        bTernary s;
+        for (size_t i = trit_width(); i-- > 0;) {
+            int t = trit(i);
+            if (s.empty() && t == 0) continue;
+            s.push_back(t > 0 ? '1' : t < 0 ? 'z' : '0');
+        }
+        return s;
+    }
+
+    // throws std::overflow_error when the value does not fit
+    int64_t to_int64() const {
+        // INT64_MIN ends in trit 1, so 3 * prefix dips one below the range before the last add;
+        // accumulate wider. A prefix above 2^64 in magnitude can no longer come back into range
+        const __int128 bound = static_cast<__int128>(1) << 64;
+        __int128 v = 0;
+        for (size_t i = trit_width(); i-- > 0;) {
+            v = v * 3 + trit(i);
+            if (v > bound || v < -bound) break;
+        }
+        if (v > INT64_MAX || v < INT64_MIN) throw std::overflow_error("PackedTernary::to_int64: value does not fit in int64_t");
+        return static_cast<int64_t>(v);
+    }
+
+    size_t words() const { return w.size(); }
+    size_t trit_width() const { return w.size() * TRITS_PER_WORD; }
+    const std::vector<uint64_t>& data() const { return w; }
+    bool is_zero() const { return w.empty(); }
+
+    int trit(size_t i) const {
+        if (i >= trit_width()) return 0;
+        uint64_t x = w[i / TRITS_PER_WORD] >> (i % TRITS_PER_WORD);
+        return (x & 1) ? 1 : (x >> 32 & 1) ? -1 : 0;
+    }
+
+    int sign() const {
+        if (w.empty()) return 0;
+        // the top word is nonzero; its highest set bit is in the plane of the leading trit
+        return (w.back() >> 32) > packed_ternary_detail::plus_plane(w.back()) ? -1 : 1;
+    }
+
+    void negate() { ternary_negate(w.data(), w.size()); }
+
+    PackedTernary operator-() const {
+        PackedTernary r = *this;
+        r.negate();
+        return r;
+    }
+
+    PackedTernary& operator+=(const PackedTernary& o) {
+        add_at(o.w.data(), o.w.size(), 0, 1);
+        trim();
+        return *this;
+    }
+
+    PackedTernary& operator-=(const PackedTernary& o) {
+        add_at(o.w.data(), o.w.size(), 0, -1);
+        trim();
+        return *this;
+    }
+
+    // schoolbook over the trits of the shorter operand; each of the 32 trit shifts of the longer
+    // one is built once, on first use, so every nonzero trit costs one word-aligned add
+    friend PackedTernary operator*(const PackedTernary& x, const PackedTernary& y) {
+        using namespace packed_ternary_detail;
+        const PackedTernary& a = x.words() >= y.words() ? x : y;
+        const PackedTernary& b = x.words() >= y.words() ? y : x;
+        PackedTernary r;
+        if (b.is_zero()) return r;
+        const size_t len = a.w.size() + 1;
+        std::vector<uint64_t> shifted(len * TRITS_PER_WORD);
+        uint32_t built = 0;
+        r.w.assign(a.w.size() + b.w.size() + 1, 0);
+        for (size_t q = 0; q < b.w.size(); ++q) {
+            uint32_t p = plus_plane(b.w[q]), n = minus_plane(b.w[q]);
+            for (uint32_t m = p | n; m != 0; m &= m - 1) {
+                int s = __builtin_ctz(m);
+                uint64_t* v = shifted.data() + s * len;
+                if (!(built >> s & 1)) {
+                    built |= 1u << s;
+                    for (size_t i = 0; i < a.w.size(); ++i) {
+                        uint64_t ap = static_cast<uint64_t>(plus_plane(a.w[i])) << s;
+                        uint64_t an = static_cast<uint64_t>(minus_plane(a.w[i])) << s;
+                        v[i] |= pack(static_cast<uint32_t>(ap), static_cast<uint32_t>(an));
+                        v[i + 1] = pack(static_cast<uint32_t>(ap >> 32), static_cast<uint32_t>(an >> 32));
+                    }
+                }
+                r.add_at(v, v[len - 1] ? len : len - 1, q, (p >> s & 1) ? 1 : -1);
+            }
+        }
+        r.trim();
+        return r;
+    }
+
+    PackedTernary& operator*=(const PackedTernary& o) { return *this = *this * o; }
+
+    friend PackedTernary operator+(PackedTernary a, const PackedTernary& b) { return a += b; }
+    friend PackedTernary operator-(PackedTernary a, const PackedTernary& b) { return a -= b; }
+
+    // a longer (trimmed) value is larger in magnitude, so its sign decides
+    friend int compare(const PackedTernary& a, const PackedTernary& b) {
+        if (a.w.size() > b.w.size()) return a.sign();
+        if (a.w.size() < b.w.size()) return -b.sign();
+        return ternary_compare(a.w.data(), b.w.data(), a.w.size());
+    }
+
+    friend bool operator==(const PackedTernary& a, const PackedTernary& b) { return a.w == b.w; }
+    friend bool operator!=(const PackedTernary& a, const PackedTernary& b) { return a.w != b.w; }
+    friend bool operator<(const PackedTernary& a, const PackedTernary& b) { return compare(a, b) < 0; }
+    friend bool operator>(const PackedTernary& a, const PackedTernary& b) { return compare(a, b) > 0; }
+    friend bool operator<=(const PackedTernary& a, const PackedTernary& b) { return compare(a, b) <= 0; }
+    friend bool operator>=(const PackedTernary& a, const PackedTernary& b) { return compare(a, b) >= 0; }
+
+    // missing trits are 0: min keeps the -1 trits above the shorter operand, max the +1 trits
+    friend PackedTernary tritwise_min(const PackedTernary& a, const PackedTernary& b) {
+        return tritwise(a, b, ternary_tritwise_min, [](uint64_t t) { return t & ~uint64_t(0xffffffff); });
+    }
+
+    friend PackedTernary tritwise_max(const PackedTernary& a, const PackedTernary& b) {
+        return tritwise(a, b, ternary_tritwise_max, [](uint64_t t) { return t & 0xffffffff; });
+    }
+
+private:
+    template <typename Op, typename Tail>
+    static PackedTernary tritwise(const PackedTernary& a, const PackedTernary& b, Op op, Tail tail) {
+        const PackedTernary& lo = a.w.size() <= b.w.size() ? a : b;
+        const PackedTernary& hi = a.w.size() <= b.w.size() ? b : a;
+        PackedTernary r;
+        r.w.resize(hi.w.size());
+        op(r.w.data(), lo.w.data(), hi.w.data(), lo.w.size());
+        for (size_t i = lo.w.size(); i < hi.w.size(); ++i) r.w[i] = tail(hi.w[i]);
+        r.trim();
+        return r;
+    }
+};
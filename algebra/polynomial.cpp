@@ -0,0 +1,128 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "ntt.cpp"
+
+// Polynomial toolkit over Z/MOD for NTT-friendly primes, plus arbitrary moduli through 3-prime CRT.
+// Polynomials are coefficient vectors, lowest degree first, coefficients in [0, MOD).
+namespace poly {
+
+using vec = std::vector<uint32_t>;
+
+// one engine (and twiddle table) per modulus
+template <uint32_t MOD>
+NTT<MOD>& engine() {
+    static NTT<MOD> e;
+    return e;
+}
+
+template <uint32_t MOD>
+vec multiply(const vec& a, const vec& b) {
+    return engine<MOD>().multiply(a, b);
+}
+
+// a truncated or zero-padded to n coefficients
+inline vec truncate(const vec& a, size_t n) {
+    vec r(a.begin(), a.begin() + std::min(a.size(), n));
+    r.resize(n, 0);
+    return r;
+}
+
+// 1..n inverses in O(n): inv[i] = -(MOD / i) * inv[MOD % i]
+template <uint32_t MOD>
+vec inverse_table(size_t n) {
+    vec inv(n + 1, 0);
+    if (n >= 1) inv[1] = 1;
+    for (size_t i = 2; i <= n; ++i) {
+        inv[i] = static_cast<uint32_t>(MOD - static_cast<uint64_t>(MOD / i) * inv[MOD % i] % MOD);
+    }
+    return inv;
+}
+
+// 1 / a mod x^n by Newton iteration g <- g (2 - a g), requires a[0] != 0
+template <uint32_t MOD>
+vec inverse(const vec& a, size_t n) {
+    if (a.empty() || a[0] == 0) throw std::invalid_argument("poly::inverse: constant term must be invertible");
+    vec g{static_cast<uint32_t>(mod_inverse_prime(a[0], MOD))};
+    for (size_t k = 1; k < n; k <<= 1) {
+        size_t m = k << 1;
+        vec t = truncate(multiply<MOD>(truncate(a, m), g), m);
+        for (auto& x : t) x = x == 0 ? 0 : MOD - x;
+        t[0] = static_cast<uint32_t>((t[0] + 2) % MOD);
+        g = truncate(multiply<MOD>(g, t), m);
+    }
+    return truncate(g, n);
+}
+
+template <uint32_t MOD>
+vec derivative(const vec& a) {
+    if (a.size() <= 1) return {};
+    vec r(a.size() - 1);
+    for (size_t i = 1; i < a.size(); ++i) r[i - 1] = static_cast<uint32_t>(static_cast<uint64_t>(a[i]) * i % MOD);
+    return r;
+}
+
+template <uint32_t MOD>
+vec integral(const vec& a) {
+    vec inv = inverse_table<MOD>(a.size());
+    vec r(a.size() + 1, 0);
+    for (size_t i = 0; i < a.size(); ++i) r[i + 1] = static_cast<uint32_t>(static_cast<uint64_t>(a[i]) * inv[i + 1] % MOD);
+    return r;
+}
+
+// log a mod x^n = integral(a' / a), requires a[0] == 1
+template <uint32_t MOD>
+vec log(const vec& a, size_t n) {
+    if (a.empty() || a[0] != 1) throw std::invalid_argument("poly::log: constant term must be 1");
+    if (n == 0) return {};
+    vec q = truncate(multiply<MOD>(derivative<MOD>(truncate(a, n)), inverse<MOD>(a, n)), n - 1);
+    return truncate(integral<MOD>(q), n);
+}
+
+// exp a mod x^n by Newton iteration g <- g (1 - log g + a), requires a[0] == 0
+template <uint32_t MOD>
+vec exp(const vec& a, size_t n) {
+    if (!a.empty() && a[0] != 0) throw std::invalid_argument("poly::exp: constant term must be 0");
+    vec g{1};
+    for (size_t k = 1; k < n; k <<= 1) {
+        size_t m = k << 1;
+        vec t = log<MOD>(g, m);
+        for (size_t i = 0; i < m; ++i) {
+            uint32_t ai = i < a.size() ? a[i] : 0;
+            t[i] = ai >= t[i] ? ai - t[i] : ai + MOD - t[i];
+        }
+        t[0] = (t[0] + 1) % MOD;
+        g = truncate(multiply<MOD>(g, t), m);
+    }
+    return truncate(g, n);
+}
+
+// a * b modulo any mod < 2^30 (product length up to 2^23): three NTT primes and Garner's CRT
+inline vec multiply_mod(const vec& a, const vec& b, uint32_t mod) {
+    constexpr uint32_t M1 = 998244353, M2 = 167772161, M3 = 469762049;
+    if (mod == 0 || mod >= (1u << 30)) throw std::invalid_argument("poly::multiply_mod: mod must be in [1, 2^30)");
+    auto reduced = [](const vec& x, uint32_t m) {
+        vec r(x.size());
+        for (size_t i = 0; i < x.size(); ++i) r[i] = x[i] % m;
+        return r;
+    };
+    vec r1 = multiply<M1>(reduced(a, M1), reduced(b, M1));
+    vec r2 = multiply<M2>(reduced(a, M2), reduced(b, M2));
+    vec r3 = multiply<M3>(reduced(a, M3), reduced(b, M3));
+
+    static const uint64_t inv_m1_m2 = mod_inverse_prime(M1 % M2, M2);
+    static const uint64_t inv_m1m2_m3 = mod_inverse_prime(static_cast<uint64_t>(M1) * M2 % M3, M3);
+    const uint64_t m1_mod = M1 % mod, m1m2_mod = static_cast<uint64_t>(M1) * M2 % mod;
+    vec r(r1.size());
+    for (size_t i = 0; i < r.size(); ++i) {
+        uint64_t v1 = r1[i];
+        uint64_t v2 = (r2[i] + M2 - v1 % M2) % M2 * inv_m1_m2 % M2;
+        uint64_t v3 = (r3[i] + M3 - (v1 + v2 * M1) % M3) % M3 * inv_m1m2_m3 % M3;
+        r[i] = static_cast<uint32_t>((v1 % mod + v2 * m1_mod % mod + v3 * m1m2_mod % mod) % mod);
+    }
+    return r;
+}
+
+} // namespace poly
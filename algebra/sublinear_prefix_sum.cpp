@@ -0,0 +1,205 @@
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "linear_sieve.cpp"
+#include "../runtime/work_stealing.cpp"
+
+// Sublinear prefix sums of arithmetic functions, for n far beyond what a sieve can materialize.
+//
+//   DuSieve        sum of phi(i) and Mertens M(n) = sum of mu(i), O(n^{2/3}) with threshold ~ n^{2/3}
+//   prime_pi       Lucy_Hedgehog prime counting, O(n^{3/4})
+//
+// DuSieve seeds from a LinearSieve table up to `threshold`, prime_pi from one up to sqrt(n); values of
+// n / i above it are kept in flat arrays indexed by i (v = n / i > threshold implies i < sqrt(n), one
+// slot per distinct v).
+
+using u128 = unsigned __int128;
+
+namespace sublinear {
+
+inline uint64_t isqrt(uint64_t n) {
+    uint64_t r = static_cast<uint64_t>(std::sqrt(static_cast<double>(n)));
+    // the double estimate can land on 2^32, whose square wraps
+    while (r > UINT32_MAX || r * r > n) --r;
+    while (r < UINT32_MAX && (r + 1) * (r + 1) <= n) ++r;
+    return r;
+}
+
+inline uint64_t icbrt_squared(uint64_t n) {
+    uint64_t r = static_cast<uint64_t>(std::cbrt(static_cast<double>(n)));
+    return r * r;
+}
+
+inline std::string to_string(u128 x) {
+    if (x == 0) return "0";
+    std::string s;
+    while (x > 0) {
+        s.push_back(static_cast<char>('0' + static_cast<int>(x % 10)));
+        x /= 10;
+    }
+    std::reverse(s.begin(), s.end());
+    return s;
+}
+
+} // namespace sublinear
+
+// run f(i) for every i in [begin, end] on up to num_threads workers of the shared runtime; small i
+// cost the most, so the range is cut into about 16 pieces per thread handed out on demand
+template <typename F>
+void parallel_each(uint64_t begin, uint64_t end, int num_threads, F f) {
+    if (num_threads <= 1 || end - begin < 64) {
+        for (uint64_t i = begin; i <= end; ++i) f(i);
+        return;
+    }
+    int64_t count = static_cast<int64_t>(end - begin + 1);
+    int64_t grain = std::max<int64_t>(1, count / (static_cast<int64_t>(num_threads) * 16));
+    ws::parallel_for(0, count, grain, [&](int64_t b, int64_t e) {
+        for (int64_t i = b; i < e; ++i) f(begin + static_cast<uint64_t>(i));
+    }, num_threads);
+}
+
+class DuSieve {
+private:
+    uint64_t n;
+    uint64_t threshold;
+    std::vector<uint64_t> small_phi;   // Phi(v) for v <= threshold
+    std::vector<int32_t> small_mu;     // M(v) for v <= threshold
+    std::vector<u128> big_phi;         // big_phi[i] = Phi(n / i) for n / i > threshold
+    std::vector<int64_t> big_mu;
+
+    // Phi(v) = v(v+1)/2 - sum_{d=2..v} Phi(v/d),  M(v) = 1 - sum_{d=2..v} M(v/d)
+    void compute(uint64_t i) {
+        uint64_t v = n / i;
+        u128 sphi = static_cast<u128>(v) * (v + 1) / 2;
+        int64_t smu = 1;
+        for (uint64_t d = 2; d <= v;) {
+            uint64_t q = v / d;
+            uint64_t d2 = v / q;
+            uint64_t cnt = d2 - d + 1;
+            if (q <= threshold) {
+                sphi -= static_cast<u128>(cnt) * small_phi[q];
+                smu -= static_cast<int64_t>(cnt) * small_mu[q];
+            } else {
+                sphi -= static_cast<u128>(cnt) * big_phi[i * d];
+                smu -= static_cast<int64_t>(cnt) * big_mu[i * d];
+            }
+            d = d2 + 1;
+        }
+        big_phi[i] = sphi;
+        big_mu[i] = smu;
+    }
+
+public:
+    // threshold == 0 picks n^{2/3}; it is raised to at least sqrt(n) and capped at n.
+    // num_threads caps the runtime workers filling the large values
+    DuSieve(uint64_t limit, uint64_t thr = 0, int num_threads = 1) : n(limit) {
+        if (n < 1) throw std::invalid_argument("Input must be a positive integer.");
+        threshold = thr == 0 ? sublinear::icbrt_squared(n) : thr;
+        threshold = std::min(n, std::max(threshold, sublinear::isqrt(n)));
+        if (threshold >= UINT32_MAX) throw std::invalid_argument("DuSieve: threshold must be below 2^32 - 1");
+
+        {
+            LinearSieve<sieve_policy::Phi, sieve_policy::Mobius> table(static_cast<uint32_t>(threshold));
+            const uint32_t* phi = table.values<sieve_policy::Phi>();
+            const int8_t* mu = table.values<sieve_policy::Mobius>();
+            small_phi.assign(threshold + 1, 0);
+            small_mu.assign(threshold + 1, 0);
+            for (uint64_t v = 1; v <= threshold; ++v) {
+                small_phi[v] = small_phi[v - 1] + phi[v];
+                small_mu[v] = small_mu[v - 1] + mu[v];
+            }
+        }
+
+        // big[i] needs big[i * d], d >= 2: every i in (k/2, k] only reads finished slots above k
+        uint64_t k = n / (threshold + 1);
+        big_phi.assign(k + 1, 0);
+        big_mu.assign(k + 1, 0);
+        for (uint64_t hi = k; hi >= 1; hi /= 2) {
+            parallel_each(hi / 2 + 1, hi, num_threads, [this](uint64_t i) { compute(i); });
+        }
+    }
+
+    uint64_t limit() const { return n; }
+
+    // v must be <= threshold or of the form n / i
+    u128 totient_sum(uint64_t v) const {
+        if (v <= threshold) return small_phi[v];
+        uint64_t i = n / v;
+        if (n / i != v) throw std::invalid_argument("DuSieve::totient_sum: v is not of the form n / i");
+        return big_phi[i];
+    }
+
+    int64_t mertens(uint64_t v) const {
+        if (v <= threshold) return small_mu[v];
+        uint64_t i = n / v;
+        if (n / i != v) throw std::invalid_argument("DuSieve::mertens: v is not of the form n / i");
+        return big_mu[i];
+    }
+
+    size_t memory_bytes() const {
+        return small_phi.size() * sizeof(uint64_t) + small_mu.size() * sizeof(int32_t) +
+               big_phi.size() * sizeof(u128) + big_mu.size() * sizeof(int64_t);
+    }
+};
+
+inline u128 totient_sum(uint64_t n, uint64_t threshold = 0, int num_threads = 1) {
+    return DuSieve(n, threshold, num_threads).totient_sum(n);
+}
+
+inline int64_t mertens(uint64_t n, uint64_t threshold = 0, int num_threads = 1) {
+    return DuSieve(n, threshold, num_threads).mertens(n);
+}
+
+// pi(n) by Lucy_Hedgehog's method: S(v, p) = S(v, p-1) - (S(v/p, p-1) - S(p-1, p-1)) for v >= p^2,
+// over the sqrt(n) small values lo[v] = S(v) and the sqrt(n) large values hi[i] = S(n / i).
+// threshold is only the direct-lookup cutoff: n <= threshold is answered from a sieve table up to n,
+// anything larger runs Lucy, which only needs the primes up to sqrt(n) (a larger table would not
+// cut its work). threshold == 0 means always Lucy.
+inline uint64_t prime_pi(uint64_t n, uint64_t threshold = 0, int num_threads = 1) {
+    if (n < 2) return 0;
+    uint64_t r = sublinear::isqrt(n);
+    if (threshold >= UINT32_MAX) throw std::invalid_argument("prime_pi: threshold must be below 2^32 - 1");
+    LinearSieve<> table(static_cast<uint32_t>(n <= threshold ? n : r));
+    const uint32_t* primes = table.primes();
+    if (n <= threshold) {
+        return static_cast<uint64_t>(std::upper_bound(primes, primes + table.prime_count(), n) - primes);
+    }
+
+    std::vector<int64_t> lo(r + 1), hi(r + 1), next;
+    for (uint64_t v = 1; v <= r; ++v) lo[v] = static_cast<int64_t>(v) - 1;
+    for (uint64_t i = 1; i <= r; ++i) hi[i] = static_cast<int64_t>(n / i) - 1;
+
+    // below this many updates a prime step is not worth splitting across the runtime
+    const uint64_t grain = 1 << 15;
+    for (uint32_t j = 0; j < table.prime_count() && primes[j] <= r; ++j) {
+        uint64_t p = primes[j];
+        uint64_t p2 = p * p;
+        int64_t sp = lo[p - 1];
+        uint64_t hi_end = std::min(r, n / p2);
+        auto hi_value = [&](uint64_t i) {
+            uint64_t d = i * p;
+            return hi[i] - ((d <= r ? hi[d] : lo[n / d]) - sp);
+        };
+        auto lo_value = [&](uint64_t v) { return lo[v] - (lo[v / p] - sp); };
+
+        if (num_threads <= 1 || hi_end + (r >= p2 ? r - p2 : 0) < grain) {
+            // ascending i reads hi[i * p] before it is updated, descending v likewise for lo[v / p]
+            for (uint64_t i = 1; i <= hi_end; ++i) hi[i] = hi_value(i);
+            for (uint64_t v = r; v >= p2; --v) lo[v] = lo_value(v);
+            continue;
+        }
+        // parallel: compute the whole step from the old values, then publish it
+        next.assign(hi_end + 1, 0);
+        parallel_each(1, hi_end, num_threads, [&](uint64_t i) { next[i] = hi_value(i); });
+        std::copy(next.begin() + 1, next.end(), hi.begin() + 1);
+        if (r >= p2) {
+            next.assign(r + 1, 0);
+            parallel_each(p2, r, num_threads, [&](uint64_t v) { next[v] = lo_value(v); });
+            std::copy(next.begin() + p2, next.end(), lo.begin() + p2);
+        }
+    }
+    return static_cast<uint64_t>(hi[1]);
+}
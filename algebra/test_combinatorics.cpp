@@ -0,0 +1,101 @@
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#include "combinatorics.cpp"
+
+const uint64_t ROWS = 400;
+
+// rows 0..ROWS of Pascal's triangle mod m
+std::vector<std::vector<uint32_t>> pascal(uint32_t m) {
+    std::vector<std::vector<uint32_t>> c(ROWS + 1);
+    for (uint64_t n = 0; n <= ROWS; ++n) {
+        c[n].assign(n + 1, 1 % m);
+        for (uint64_t k = 1; k < n; ++k) c[n][k] = (c[n - 1][k - 1] + c[n - 1][k]) % m;
+    }
+    return c;
+}
+
+// every C(n, k) with n <= ROWS, k <= n + 2, against Pascal's triangle
+template <typename B>
+void check_small(const B& b, uint32_t m) {
+    auto c = pascal(m);
+    for (uint64_t n = 0; n <= ROWS; ++n) {
+        for (uint64_t k = 0; k <= n + 2; ++k) assert(b.binom(n, k) == (k <= n ? c[n][k] : 0));
+    }
+}
+
+// n far past every table: C(n, 0) = C(n, n) = 1, C(n, 1) = n, C(n, 2) = n(n-1)/2
+template <typename B>
+void check_large(const B& b, uint32_t m) {
+    for (uint64_t n : {uint64_t(1) << 40, uint64_t(999999999999999989ull), UINT64_MAX - 1}) {
+        assert(b.binom(n, 0) == 1 % m && b.binom(n, n) == 1 % m);
+        assert(b.binom(n, 1) == n % m && b.binom(n, n - 1) == n % m);
+        uint64_t half = static_cast<uint64_t>((static_cast<unsigned __int128>(n) * (n - 1) / 2) % m);
+        assert(b.binom(n, 2) == half);
+        assert(b.binom(n, n + 1) == 0);
+    }
+}
+
+int brute_totient(int n) {
+    int count = 0;
+    for (int i = 1; i <= n; ++i) count += std::gcd(i, n) == 1;
+    return count;
+}
+
+int main() {
+    using namespace std;
+    for (uint32_t p : {2u, 3u, 5u, 7u, 13u, 10007u}) {
+        LucasBinomial lucas(p);
+        check_small(lucas, p);
+        check_large(lucas, p);
+        // C(p^j, k) = 0 mod p for 0 < k < p^j
+        assert(lucas.binom(uint64_t(p) * p, p) == 0 && lucas.binom(uint64_t(p) * p * p, 1) == 0);
+    }
+    for (uint32_t m : {1u, 2u, 5u, 8u, 9u, 12u, 25u, 27u, 360u, 10007u, 1u << 20}) {
+        BinomialMod b(m, UINT64_MAX);
+        assert(b.modulus() == m);
+        check_small(b, m);
+        check_large(b, m);
+    }
+    // a prime above max_n takes the factorial-table path
+    check_small(BinomialMod(10007, ROWS), 10007);
+    check_small(BinomialMod(1000000007, ROWS), 1000000007);
+    check_small(FactorialTable(ROWS, 1009), 1009);
+
+    binom_query qs[] = {{0, 0}, {0, 1}, {5, 7}, {400, 200}, {UINT64_MAX, UINT64_MAX}};
+    uint32_t out[5];
+    BinomialMod(360, UINT64_MAX).binom_batch(qs, 5, out);
+    assert(out[0] == 1 && out[1] == 0 && out[2] == 0 && out[3] == pascal(360)[400][200] && out[4] == 1);
+
+    bool threw = false;
+    try { BinomialMod(0, 10); } catch (const invalid_argument&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { BinomialMod(1u << 31, 10); } catch (const invalid_argument&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { BinomialMod(1u << 30, 10); } catch (const invalid_argument&) { threw = true; }   // 2^30 exceeds MAX_TABLE
+    assert(threw);
+    threw = false;
+    try { FactorialTable(10, 7); } catch (const invalid_argument&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { BinomialMod(10007, ROWS).binom(ROWS + 1, 1); } catch (const out_of_range&) { threw = true; }
+    assert(threw);
+
+    // totient of prime powers: brute force where it is cheap, p^{e-1}(p - 1) up to 2^31
+    for (int p : {2, 3, 5, 7, 11, 97, 1009}) {
+        for (int64_t pe = p; pe <= 2000000; pe *= p) {
+            assert(totient_single(static_cast<int>(pe)) == brute_totient(static_cast<int>(pe)));
+        }
+    }
+    assert(totient_single(1) == 1);
+    assert(totient_single(1 << 30) == 1 << 29);
+    assert(totient_single(46337 * 46337) == 46337 * 46336);
+    assert(totient_single(2147483647) == 2147483646);
+
+    cout << "Combinatorics tests passed" << endl;
+    return 0;
+}
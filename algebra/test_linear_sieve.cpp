@@ -0,0 +1,78 @@
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include "linear_sieve.cpp"
+
+using namespace sieve_policy;
+
+// every arithmetic function by trial division
+struct Reference {
+    uint32_t phi = 1, spf = 0;
+    int mu = 1, omega = 0;
+    uint64_t divisors = 1, sigma = 1;
+};
+
+Reference by_trial_division(uint32_t n) {
+    Reference r;
+    auto prime_power = [&r](uint64_t p, int e, uint64_t pk) {
+        if (r.spf == 0) r.spf = static_cast<uint32_t>(p);
+        r.phi *= static_cast<uint32_t>(pk / p * (p - 1));
+        r.mu = e == 1 ? -r.mu : 0;
+        r.omega += 1;
+        r.divisors *= e + 1;
+        r.sigma *= (pk * p - 1) / (p - 1);
+    };
+    uint64_t m = n;
+    for (uint64_t p = 2; p * p <= m; ++p) {
+        if (m % p != 0) continue;
+        int e = 0;
+        uint64_t pk = 1;
+        while (m % p == 0) {
+            m /= p;
+            pk *= p;
+            ++e;
+        }
+        prime_power(p, e, pk);
+    }
+    if (m > 1) prime_power(m, 1, m);
+    return r;
+}
+
+void check(uint32_t limit) {
+    LinearSieve<Phi, Mobius, DivisorCount, DivisorSum, Omega, SmallestPrimeFactor> s(limit);
+    assert(s.limit() == limit);
+    uint32_t primes = 0;
+    for (uint32_t i = 1; i <= limit; ++i) {
+        Reference r = by_trial_division(i);
+        assert(s.at<Phi>(i) == r.phi);
+        assert(s.at<Mobius>(i) == r.mu);
+        assert(s.at<DivisorCount>(i) == r.divisors);
+        assert(s.at<DivisorSum>(i) == r.sigma);
+        assert(s.at<Omega>(i) == r.omega);
+        assert(s.at<SmallestPrimeFactor>(i) == r.spf);
+        if (r.spf == i) {
+            assert(s.primes()[primes] == i);
+            ++primes;
+        }
+    }
+    assert(s.prime_count() == primes);
+}
+
+int main() {
+    using namespace std;
+    for (uint32_t limit : {1u, 2u, 3u, 4u, 97u, 1024u, 199999u, 200000u}) check(limit);
+
+    LinearSieve<Phi> one(1);
+    assert(one.prime_count() == 0);
+    assert(LinearSieve<Omega>(199999).primes()[17983] == 199999);   // a prime limit is included
+
+    bool threw = false;
+    try { LinearSieve<Phi> bad(0); } catch (const invalid_argument&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { one.at<Phi>(2); } catch (const out_of_range&) { threw = true; }
+    assert(threw);
+
+    cout << "LinearSieve tests passed" << endl;
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include <iostream>
+#include <cassert>
+#include <climits>
+#include <random>
+#include "packed_ternary.cpp"
+
+using PT = PackedTernary;
+
+std::mt19937_64 rng(42);
+
+// random value of up to `bits` bits, either sign
+int64_t random_value(int bits) {
+    int64_t v = static_cast<int64_t>(rng() >> (64 - bits));
+    return rng() & 1 ? -v : v;
+}
+
+// r holds exactly the trits f(a.trit(i), b.trit(i)), with no zero words on top
+template <typename F>
+void check_tritwise(const PT& r, const PT& a, const PT& b, F f) {
+    size_t width = std::max(a.trit_width(), b.trit_width()) + PT::TRITS_PER_WORD;
+    for (size_t i = 0; i < width; ++i) assert(r.trit(i) == f(a.trit(i), b.trit(i)));
+    assert(r.is_zero() || r.data().back() != 0);
+}
+
+void check_arithmetic(int64_t x, int64_t y) {
+    PT a(x), b(y);
+    assert(a.to_int64() == x && b.to_int64() == y);
+    assert((a + b).to_int64() == x + y);
+    assert((a - b).to_int64() == x - y);
+    assert((-a).to_int64() == -x);
+    PT c = a;
+    c.negate();
+    assert(c == -a && c + a == PT());
+    c = a;
+    c += b;
+    c -= b;
+    assert(c == a);
+    int expect = x < y ? -1 : x > y ? 1 : 0;
+    assert(compare(a, b) == expect && compare(b, a) == -expect);
+    assert((a < b) == (x < y) && (a > b) == (x > y) && (a <= b) == (x <= y) && (a >= b) == (x >= y));
+    assert((a == b) == (x == y) && (a != b) == (x != y));
+    assert(a.sign() == (x > 0) - (x < 0));
+    check_tritwise(tritwise_min(a, b), a, b, [](int s, int t) { return std::min(s, t); });
+    check_tritwise(tritwise_max(a, b), a, b, [](int s, int t) { return std::max(s, t); });
+}
+
+// raw word arrays: fixed width, carries out of the top word are returned
+void check_raw() {
+    const uint64_t ones = 0xffffffffull, minus_ones = ones << 32;   // 32 trits of +1 / -1
+    uint64_t a[3] = {ones, ones, ones}, one[3] = {1, 0, 0}, zero[3] = {0, 0, 0}, dst[3];
+
+    // (3^96 - 1) / 2 + 1 = 3^96 - (3^96 - 1) / 2: every trit flips to -1 and the carry leaves the top
+    assert(ternary_add(dst, a, one, 3) == 1);
+    for (uint64_t w : dst) assert(w == minus_ones);
+    // and back, borrowing across both word boundaries
+    assert(ternary_sub(dst, dst, one, 3) == -1);
+    for (uint64_t w : dst) assert(w == ones);
+    // carry_in alone ripples the same way
+    assert(ternary_add(dst, a, zero, 3, 1) == 1);
+    for (uint64_t w : dst) assert(w == minus_ones);
+    assert(ternary_add(dst, dst, zero, 3, -1) == -1);
+    for (uint64_t w : dst) assert(w == ones);
+
+    // a carry stops at the first word that absorbs it
+    uint64_t b[3] = {ones, 0, ones};
+    assert(ternary_add(dst, b, one, 3) == 0);
+    assert(dst[0] == minus_ones && dst[1] == 1 && dst[2] == ones);
+
+    uint64_t n[3] = {ones, minus_ones, 5};
+    ternary_negate(n, 3);
+    assert(n[0] == minus_ones && n[1] == ones && n[2] == 5ull << 32);
+
+    assert(ternary_compare(a, a, 3) == 0);
+    assert(ternary_compare(a, b, 3) == 1 && ternary_compare(b, a, 3) == -1);
+    assert(ternary_compare(n, zero, 3) == -1);
+
+    uint64_t m[3];
+    ternary_tritwise_min(m, a, n, 3);
+    assert(m[0] == minus_ones && m[1] == ones && m[2] == (5ull << 32));
+    ternary_tritwise_max(m, a, n, 3);
+    assert(m[0] == ones && m[1] == ones && m[2] == ones);
+}
+
+int main() {
+    using namespace std;
+    for (int x = -400; x <= 400; ++x) {
+        PT p(x);
+        assert(p.to_int64() == x && p.to_chars() == dec2ter(x));
+        assert(PT::from_chars(dec2ter(x)) == p);
+        for (int y = -40; y <= 40; ++y) {
+            check_arithmetic(x, y);
+            assert((p * PT(y)).to_int64() == x * y);
+        }
+    }
+    for (int bits : {10, 31, 33, 50, 62}) {
+        for (int i = 0; i < 2000; ++i) {
+            int64_t x = random_value(bits), y = random_value(bits);
+            check_arithmetic(x, y);
+            int64_t s = random_value(31), t = random_value(31);
+            assert((PT(s) * PT(t)).to_int64() == s * t);
+        }
+    }
+
+    // 32 trits of +1 plus one: a carry through a whole word into the next
+    PT all_ones = PT::from_chars(bTernary(32, '1'));
+    const int64_t half = (1853020188851841ll - 1) / 2;   // (3^32 - 1) / 2
+    assert(all_ones.words() == 1 && all_ones.to_int64() == half);
+    PT rippled = all_ones + PT(1);
+    assert(rippled.words() == 2 && rippled.to_int64() == half + 1);
+    bTernary expect(1, '1');
+    expect.insert(expect.end(), 32, 'z');
+    assert(rippled.to_chars() == expect);
+    assert(rippled - PT(1) == all_ones && (-rippled - PT(-1)) == -all_ones);
+    // wider: 96 trits of +1, two boundaries
+    PT wide = PT::from_chars(bTernary(96, '1'));
+    PT wide_rippled = wide + PT(1);
+    assert(wide_rippled.words() == 4 && wide_rippled.trit(96) == 1);
+    for (int i = 0; i < 96; ++i) assert(wide_rippled.trit(i) == -1);
+    assert(wide_rippled - PT(1) == wide);
+    assert(compare(wide_rippled, wide) == 1 && compare(-wide_rippled, -wide) == -1);
+    // growing into a new word, and cancelling back out of it
+    assert((all_ones + all_ones).words() == 2 && (all_ones + all_ones).to_int64() == 2 * half);
+    assert((rippled - rippled).is_zero() && (rippled + -rippled).words() == 0);
+    assert(all_ones * PT(2) == all_ones + all_ones && rippled * PT(-3) == -(rippled + rippled + rippled));
+
+    // int64 limits
+    for (int64_t v : {INT64_MIN, INT64_MIN + 1, INT64_MAX, INT64_MAX - 1, int64_t(0)}) {
+        PT p(v);
+        assert(p.to_int64() == v);
+        assert(PT::from_chars(p.to_chars()) == p);
+    }
+    assert((PT(INT64_MIN) + PT(INT64_MAX)).to_int64() == -1);
+    assert(-PT(INT64_MAX) - PT(1) == PT(INT64_MIN));
+    for (PT over : {PT(INT64_MAX) + PT(1), PT(INT64_MIN) - PT(1), -PT(INT64_MIN), wide}) {
+        bool threw = false;
+        try { over.to_int64(); } catch (const overflow_error&) { threw = true; }
+        assert(threw);
+    }
+
+    check_raw();
+
+    PT zero;
+    assert(zero.is_zero() && zero.sign() == 0 && zero.to_chars().empty() && zero.to_int64() == 0);
+    assert(PT::from_chars(bTernary(70, '0')).is_zero());
+    bool threw = false;
+    try { PT::from_chars({'1', '2'}); } catch (const invalid_argument&) { threw = true; }
+    assert(threw);
+
+    cout << "PackedTernary tests passed" << endl;
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include "polynomial.cpp"
+
+// build with and without -mavx2 to cover both NTT lanes
+using poly::vec;
+constexpr uint32_t P = 998244353;
+
+std::mt19937 rng(2024);
+
+vec random_poly(size_t n, uint32_t mod) {
+    vec a(n);
+    for (auto& x : a) x = rng() % mod;
+    return a;
+}
+
+vec schoolbook(const vec& a, const vec& b, uint32_t mod) {
+    vec r(a.size() + b.size() - 1, 0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t j = 0; j < b.size(); ++j) {
+            r[i + j] = static_cast<uint32_t>((r[i + j] + static_cast<uint64_t>(a[i]) * b[j]) % mod);
+        }
+    }
+    return r;
+}
+
+// every lane op against plain modular arithmetic, on values including 0 and MOD - 1
+template <typename V>
+void check_lane() {
+    using M = Montgomery<P>;
+    const int n = 64;
+    uint32_t a[n], b[n], out[n];
+    for (int i = 0; i < n; ++i) {
+        a[i] = i < 4 ? (i % 2 == 0 ? 0 : P - 1) : rng() % P;
+        b[i] = i < 4 ? (i < 2 ? P - 1 : 0) : rng() % P;
+    }
+    for (int i = 0; i < n; i += V::width) {
+        V::store(out + i, V::add(V::load(a + i), V::load(b + i)));
+        for (int k = i; k < i + V::width; ++k) assert(out[k] == (static_cast<uint64_t>(a[k]) + b[k]) % P);
+        V::store(out + i, V::sub(V::load(a + i), V::load(b + i)));
+        for (int k = i; k < i + V::width; ++k) assert(out[k] == (static_cast<uint64_t>(a[k]) + P - b[k]) % P);
+        uint32_t am[V::width], bm[V::width];
+        for (int k = 0; k < V::width; ++k) am[k] = M::to(a[i + k]), bm[k] = M::to(b[i + k]);
+        V::store(out + i, V::mul(V::load(am), V::load(bm)));
+        for (int k = i; k < i + V::width; ++k) assert(M::from(out[k]) == static_cast<uint64_t>(a[k]) * b[k] % P);
+    }
+}
+
+void check_ntt() {
+    using M = Montgomery<P>;
+    // sizes below, at and above the cache block, odd and even level counts
+    for (int n : {1, 2, 8, 16, 32, 1 << 11, 1 << 12, 1 << 13, 1 << 14}) {
+        vec a = random_poly(n, P), t(n);
+        for (int i = 0; i < n; ++i) t[i] = M::to(a[i]);
+        poly::engine<P>().forward(t.data(), n);
+        poly::engine<P>().inverse(t.data(), n);
+        for (int i = 0; i < n; ++i) assert(M::from(t[i]) == a[i]);
+    }
+    for (auto [n, m] : {std::pair<int, int>{1, 1}, {33, 33}, {100, 37}, {1000, 1000}, {3000, 5000}}) {
+        vec a = random_poly(n, P), b = random_poly(m, P);
+        assert(poly::multiply<P>(a, b) == schoolbook(a, b, P));
+    }
+    assert(poly::multiply<P>({}, {1, 2}).empty());
+    bool threw = false;
+    try { NTT<P>().ensure(3); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { NTT<P>().ensure(1 << 24); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+}
+
+void check_series(size_t n) {
+    vec one(n, 0);
+    one[0] = 1;
+
+    vec f = random_poly(n, P);
+    f[0] = f[0] == 0 ? 1 : f[0];
+    assert(poly::truncate(poly::multiply<P>(f, poly::inverse<P>(f, n)), n) == one);
+
+    f[0] = 1;
+    vec lf = poly::log<P>(f, n);
+    assert(lf.size() == n && lf[0] == 0);
+    assert(poly::exp<P>(lf, n) == f);
+    // (log f)' f == f'
+    vec lhs = poly::truncate(poly::multiply<P>(poly::derivative<P>(lf), f), n - 1);
+    assert(lhs == poly::derivative<P>(f));
+
+    vec g = random_poly(n, P);
+    g[0] = 0;
+    assert(poly::log<P>(poly::exp<P>(g, n), n) == g);
+}
+
+void check_multiply_mod() {
+    for (uint32_t mod : {1u, 2u, 1000000007u, (1u << 30) - 1}) {
+        for (auto [n, m] : {std::pair<int, int>{1, 1}, {50, 70}, {2000, 3000}}) {
+            vec a(n), b(m);
+            // coefficients at and just below the modulus, where the CRT bound is tightest
+            for (auto& x : a) x = mod - 1 - rng() % std::min(mod, 3u);
+            for (auto& x : b) x = mod - 1 - rng() % std::min(mod, 3u);
+            assert(poly::multiply_mod(a, b, mod) == schoolbook(a, b, mod));
+            a = random_poly(n, mod);
+            b = random_poly(m, mod);
+            assert(poly::multiply_mod(a, b, mod) == schoolbook(a, b, mod));
+        }
+    }
+    bool threw = false;
+    try { poly::multiply_mod({1}, {1}, 1u << 30); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+}
+
+int main() {
+    using namespace std;
+    check_lane<ScalarLane<P>>();
+#ifdef __AVX2__
+    check_lane<Avx2Lane<P>>();
+#endif
+    check_ntt();
+    for (size_t n : {1, 2, 3, 17, 64, 1000, 5000}) check_series(n);
+    check_multiply_mod();
+
+    bool threw = false;
+    try { poly::inverse<P>({0, 1}, 4); } catch (const invalid_argument&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { poly::log<P>({2, 1}, 4); } catch (const invalid_argument&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { poly::exp<P>({1, 1}, 4); } catch (const invalid_argument&) { threw = true; }
+    assert(threw);
+
+    cout << "Polynomial tests passed" << endl;
+    return 0;
+}
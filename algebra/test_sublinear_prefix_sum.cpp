@@ -0,0 +1,67 @@
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include "sublinear_prefix_sum.cpp"
+
+using namespace sieve_policy;
+
+// every n in [1, limit] against prefix sums of a LinearSieve table
+void check(uint32_t limit, int num_threads) {
+    LinearSieve<Phi, Mobius> s(limit);
+    u128 phi_sum = 0;
+    int64_t m = 0;
+    uint64_t pi = 0;
+    for (uint32_t n = 1; n <= limit; ++n) {
+        phi_sum += s.at<Phi>(n);
+        m += s.at<Mobius>(n);
+        if (n >= 2 && s.at<Phi>(n) == n - 1) ++pi;
+        for (uint64_t threshold : {0ull, 1ull, static_cast<unsigned long long>(sublinear::isqrt(n)), n / 2ull, 1ull * n}) {
+            assert(totient_sum(n, threshold, num_threads) == phi_sum);
+            assert(mertens(n, threshold, num_threads) == m);
+            assert(prime_pi(n, threshold, num_threads) == pi);
+        }
+    }
+}
+
+int main() {
+    using namespace std;
+    assert(sublinear::isqrt(0) == 0);
+    assert(sublinear::isqrt(UINT64_MAX) == UINT32_MAX);
+    assert(sublinear::isqrt(999999999999999999ull) == 999999999);
+    assert(sublinear::to_string(0) == "0");
+    assert(sublinear::to_string(static_cast<u128>(UINT64_MAX) * 10 + 9) == "184467440737095516159");
+
+    check(600, 1);
+    ws::set_num_threads(4);
+    check(600, 4);
+
+    // every value of n / i of a larger n, serial and parallel
+    const uint64_t n = 3000000;
+    DuSieve serial(n, 0, 1), parallel(n, 0, 4);
+    LinearSieve<Phi, Mobius> s(n);
+    u128 phi_sum = 0;
+    int64_t m = 0;
+    for (uint32_t v = 1; v <= n; ++v) {
+        phi_sum += s.at<Phi>(v);
+        m += s.at<Mobius>(v);
+        if (n / (n / v) != v) continue;
+        assert(serial.totient_sum(v) == phi_sum && parallel.totient_sum(v) == phi_sum);
+        assert(serial.mertens(v) == m && parallel.mertens(v) == m);
+    }
+    assert(prime_pi(n, 0, 1) == 216816 && prime_pi(n, 0, 4) == 216816);
+
+    // published values
+    assert(mertens(1000000000, 0, 4) == -222);
+    assert(prime_pi(10000000000ull, 0, 4) == 455052511);
+    assert(sublinear::to_string(totient_sum(1000000000, 0, 4)) == "303963551173008414");
+
+    bool threw = false;
+    try { DuSieve(0); } catch (const invalid_argument&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { serial.mertens(n - 1); } catch (const invalid_argument&) { threw = true; }
+    assert(threw);
+
+    cout << "sublinear prefix sum tests passed" << endl;
+    return 0;
+}
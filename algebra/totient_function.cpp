@@ -1,5 +1,8 @@
 #include <stdexcept>
 #include <vector>
+#include <algorithm>
+#include <cmath>
+#include "../runtime/work_stealing.cpp"
 
 using vec = std::vector<int>;
 
@@ -13,7 +16,7 @@ int totient_single(int n) {
 
     int result = n;
     // edge fator: if there is factor equals to squart of n, its exponent can more than 1, so should be included.
-    for (int p = 2; p * p <= n; ++p) {
+    for (int p = 2; p <= n / p; ++p) {
         // for any non-prime numbers, we know that their prime factors(naturally less then itself) is already checked
         // so we can skip them
         if (n % p == 0) {
@@ -23,8 +26,8 @@ int totient_single(int n) {
             result = result - result / p;
         }
     }
-    // handle last one
-    result = result - result / n; // if n == 1, the logic still works.
+    // handle last one (n == 1 means every factor was already divided out)
+    if (n > 1) result = result - result / n;
 
     return result;
 }
@@ -85,6 +88,38 @@ vec totient_range_euler(int n) {
     return result;
 }
 
+// segmented Eratosthenes on the shared runtime: each block of [1, n] divides out the primes
+// up to sqrt(n) itself, and what is left above 1 is the one prime factor larger than sqrt(n)
+vec totient_range_parallel(int n, int block = 1 << 16) {
+    if (n < 1) throw std::invalid_argument("Input must be a positive integer.");
+    int root = static_cast<int>(std::sqrt(static_cast<double>(n)));
+    while (static_cast<long long>(root + 1) * (root + 1) <= n) ++root;
+    vec small_primes;
+    std::vector<char> composite(root + 1, 0);
+    for (int i = 2; i <= root; ++i) {
+        if (composite[i]) continue;
+        small_primes.push_back(i);
+        for (long long j = static_cast<long long>(i) * i; j <= root; j += i) composite[j] = 1;
+    }
+
+    vec result(n + 1, 0);
+    ws::parallel_for(1, static_cast<int64_t>(n) + 1, std::max(1, block), [&](int64_t lo, int64_t hi) {
+        vec rest(hi - lo);
+        for (int64_t x = lo; x < hi; ++x) rest[x - lo] = result[x] = static_cast<int>(x);
+        for (int p : small_primes) {
+            for (int64_t x = (lo + p - 1) / p * p; x < hi; x += p) {
+                int& r = rest[x - lo];
+                while (r % p == 0) r /= p;
+                result[x] -= result[x] / p;
+            }
+        }
+        for (int64_t x = lo; x < hi; ++x) {
+            if (rest[x - lo] > 1) result[x] -= result[x] / rest[x - lo];
+        }
+    });
+    return result;
+}
+
 
 
 // 1 3 6 9 aK = 0 \dots n-1 (mod n)
\ No newline at end of file
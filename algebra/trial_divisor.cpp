@@ -1,6 +1,7 @@
 #include <vector>
 #include <utility>
 #include <cmath>
+#include "../runtime/work_stealing.cpp"
 
 using p = std::pair<int, int>;
 using vec_p = std::vector<p>;
@@ -37,4 +38,13 @@ vec_p find_all_prime_divisor(int n) {
         result.push_back(p(n, 1));
     }
 	return result;
-}
\ No newline at end of file
+}
+
+// factorize every value of ns on the shared runtime, `grain` values per task
+std::vector<vec_p> find_all_prime_divisor_batch(const std::vector<int>& ns, int grain = 256) {
+    std::vector<vec_p> result(ns.size());
+    ws::parallel_for(0, static_cast<int64_t>(ns.size()), grain, [&](int64_t b, int64_t e) {
+        for (int64_t i = b; i < e; ++i) result[i] = find_all_prime_divisor(ns[i]);
+    });
+    return result;
+}
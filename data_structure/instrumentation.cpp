@@ -0,0 +1,225 @@
+#pragma once
+// Hot-path instrumentation for the data structures.
+//
+// Everything here is switched at compile time and expands to nothing unless enabled:
+//   -DDS_INSTRUMENT          operation counters (node visits, merges, block scans, transfers)
+//   -DDS_INSTRUMENT_LATENCY  per-operation latency histograms (implies DS_INSTRUMENT)
+//   -DDS_INSTRUMENT_PERF     perf_event_open cache/branch miss counters (Linux, implies DS_INSTRUMENT)
+//
+// Counters are plain globals and are not synchronized: instrument single-threaded runs only.
+// Call ds_instrument::dump_json(std::cout) to print everything, ds_instrument::reset() to clear.
+
+#if defined(DS_INSTRUMENT_LATENCY) || defined(DS_INSTRUMENT_PERF)
+#ifndef DS_INSTRUMENT
+#define DS_INSTRUMENT
+#endif
+#endif
+
+#ifdef DS_INSTRUMENT
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <ostream>
+#include <chrono>
+
+#ifdef DS_INSTRUMENT_PERF
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ds_instrument {
+
+struct Counters {
+    uint64_t node_visits = 0;          // tree nodes touched by SegmentTree / Fenwick
+    uint64_t merge_calls = 0;          // calls to the merge function
+    uint64_t partial_block_scans = 0;  // partial blocks walked element by element
+    uint64_t partial_block_elems = 0;  // elements read inside partial blocks
+    uint64_t full_block_scans = 0;     // whole blocks answered from the summary array
+    uint64_t amortized_transfers = 0;  // elements moved between MQueue stacks / evicted from MQueue2 deque
+};
+
+inline Counters counters;
+
+// log2-bucketed latency histogram, bucket b holds samples in [2^b, 2^(b+1)) ns
+struct Histogram {
+    static constexpr int BUCKETS = 40;
+    uint64_t bucket[BUCKETS] = {};
+    uint64_t count = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+
+    void record(uint64_t ns) {
+        int b = ns == 0 ? 0 : 63 - __builtin_clzll(ns);
+        if (b >= BUCKETS) b = BUCKETS - 1;
+        ++bucket[b];
+        ++count;
+        total_ns += ns;
+        if (ns > max_ns) max_ns = ns;
+    }
+};
+
+// one histogram per operation name; std::map keeps references stable, and entries are never
+// erased because DS_LATENCY caches them in function-local statics
+inline std::map<std::string, Histogram>& histograms() {
+    static std::map<std::string, Histogram> h;
+    return h;
+}
+
+inline Histogram& histogram(const char* name) {
+    return histograms()[name];
+}
+
+class ScopedTimer {
+private:
+    Histogram& h;
+    std::chrono::steady_clock::time_point start;
+public:
+    explicit ScopedTimer(Histogram& hist) : h(hist), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        h.record(static_cast<uint64_t>(ns));
+    }
+};
+
+#ifdef DS_INSTRUMENT_PERF
+// hardware counters for a region bracketed by perf_start() / perf_stop()
+class PerfCounters {
+private:
+    int fd_cache = -1;
+    int fd_branch = -1;
+
+    static int open_counter(uint64_t config) {
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    static uint64_t read_counter(int fd) {
+        uint64_t v = 0;
+        if (fd < 0 || ::read(fd, &v, sizeof(v)) != sizeof(v)) return 0;
+        return v;
+    }
+
+public:
+    uint64_t cache_misses = 0;
+    uint64_t branch_misses = 0;
+
+    PerfCounters() {
+        fd_cache = open_counter(PERF_COUNT_HW_CACHE_MISSES);
+        fd_branch = open_counter(PERF_COUNT_HW_BRANCH_MISSES);
+    }
+    ~PerfCounters() {
+        if (fd_cache >= 0) close(fd_cache);
+        if (fd_branch >= 0) close(fd_branch);
+    }
+
+    bool available() const { return fd_cache >= 0 || fd_branch >= 0; }
+
+    void start() {
+        for (int fd : {fd_cache, fd_branch}) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    void stop() {
+        for (int fd : {fd_cache, fd_branch}) {
+            if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        cache_misses += read_counter(fd_cache);
+        branch_misses += read_counter(fd_branch);
+    }
+};
+
+inline PerfCounters& perf() {
+    static PerfCounters p;
+    return p;
+}
+
+inline void perf_start() { perf().start(); }
+inline void perf_stop() { perf().stop(); }
+#else
+inline void perf_start() {}
+inline void perf_stop() {}
+#endif
+
+inline void reset() {
+    counters = Counters{};
+    for (auto& entry : histograms()) entry.second = Histogram{};
+#ifdef DS_INSTRUMENT_PERF
+    perf().cache_misses = 0;
+    perf().branch_misses = 0;
+#endif
+}
+
+inline void dump_json(std::ostream& os) {
+    const Counters& c = counters;
+    os << "{\"counters\":{"
+       << "\"node_visits\":" << c.node_visits
+       << ",\"merge_calls\":" << c.merge_calls
+       << ",\"partial_block_scans\":" << c.partial_block_scans
+       << ",\"partial_block_elems\":" << c.partial_block_elems
+       << ",\"full_block_scans\":" << c.full_block_scans
+       << ",\"amortized_transfers\":" << c.amortized_transfers
+       << "},\"latency\":{";
+    bool first = true;
+    for (const auto& [name, h] : histograms()) {
+        if (h.count == 0) continue;
+        if (!first) os << ",";
+        first = false;
+        os << "\"" << name << "\":{\"count\":" << h.count
+           << ",\"total_ns\":" << h.total_ns
+           << ",\"max_ns\":" << h.max_ns
+           << ",\"log2_ns_buckets\":[";
+        int last = Histogram::BUCKETS - 1;
+        while (last > 0 && h.bucket[last] == 0) --last;
+        for (int b = 0; b <= last; ++b) os << (b ? "," : "") << h.bucket[b];
+        os << "]}";
+    }
+    os << "}";
+#ifdef DS_INSTRUMENT_PERF
+    os << ",\"perf\":{\"available\":" << (perf().available() ? "true" : "false")
+       << ",\"cache_misses\":" << perf().cache_misses
+       << ",\"branch_misses\":" << perf().branch_misses << "}";
+#endif
+    os << "}\n";
+}
+
+} // namespace ds_instrument
+
+#define DS_COUNT(field, n) (ds_instrument::counters.field += (n))
+
+// times the rest of the enclosing scope; place it after argument validation so rejected calls
+// are not recorded
+#ifdef DS_INSTRUMENT_LATENCY
+#define DS_LATENCY(name) \
+    static ds_instrument::Histogram& ds_latency_hist_ = ds_instrument::histogram(name); \
+    ds_instrument::ScopedTimer ds_latency_timer_(ds_latency_hist_)
+#else
+#define DS_LATENCY(name) ((void)0)
+#endif
+
+#else // !DS_INSTRUMENT
+
+#include <ostream>
+
+namespace ds_instrument {
+inline void perf_start() {}
+inline void perf_stop() {}
+inline void reset() {}
+inline void dump_json(std::ostream& os) { os << "{}\n"; }
+} // namespace ds_instrument
+
+#define DS_COUNT(field, n) ((void)0)
+#define DS_LATENCY(name) ((void)0)
+
+#endif
@@ -1,18 +1,20 @@
+#pragma once
 #include <vector>
 #include <utility>
 #include <stdexcept>
 #include <algorithm>
+#include "../instrumentation.cpp"
 
 template <typename T>
 using paar = std::pair<T,T>;
 template<typename T>
-using vec = std::vector< paar<T> >;
+using paar_vec = std::vector< paar<T> >;
 
 
 template <typename T>
 class MStack{
 private:
-vec<T> self;
+paar_vec<T> self;
 public:
 bool empty() const {
     return self.empty();
@@ -77,6 +79,7 @@ const paar<T> MQueue<T>::_get_head_elem() {
         while (! in.empty()) {
             out.push(in.top());
             in.pop();
+            DS_COUNT(amortized_transfers, 1);
         }
     }
     if (in.empty()) return paar<T>(out.top(), out.min());
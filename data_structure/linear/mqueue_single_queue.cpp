@@ -2,6 +2,7 @@
 #include <deque>
 #include <algorithm>
 #include <stdexcept>
+#include "../instrumentation.cpp"
 
 // MQueue2: queue that supports O(1) amortized min query using an auxiliary monotonic deque
 template <typename T>
@@ -19,6 +20,7 @@ public:
         // maintain monotonic property of minDeque
         while (!minDeque.empty() && minDeque.back() > v) {
             minDeque.pop_back();
+            DS_COUNT(amortized_transfers, 1);
         }
         minDeque.push_back(v);
     }
@@ -0,0 +1,30 @@
+#define DS_INSTRUMENT
+#include <iostream>
+#include <cassert>
+#include "mqueue_2stack.cpp"
+#include "mqueue_single_queue.cpp"
+
+int main() {
+    using namespace std;
+    using ds_instrument::counters;
+
+    // MQueue: the first head() moves every pending element to the out stack
+    MQueue<int> q;
+    for (int i = 0; i < 5; ++i) q.add(i);
+    assert(counters.amortized_transfers == 0);
+    assert(q.head() == 0);
+    assert(counters.amortized_transfers == 5);
+    q.pop();
+    assert(q.head() == 1);
+    assert(counters.amortized_transfers == 5);
+
+    // MQueue2: each larger value is evicted by a smaller successor
+    ds_instrument::reset();
+    MQueue2<int> q2;
+    for (int v : {5, 4, 3, 6}) q2.add(v);
+    assert(counters.amortized_transfers == 2);
+    assert(q2.min() == 3);
+
+    cout << "MQueue instrumentation tests passed" << endl;
+    return 0;
+}
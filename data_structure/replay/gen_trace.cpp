@@ -0,0 +1,92 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <limits>
+#include "op_trace.cpp"
+
+// write a synthetic op trace for replay.cpp.
+// build: g++ -std=c++17 -O2 gen_trace.cpp -o gen_trace
+// usage: gen_trace <out> [options]
+//   --kind range|sequence       default range
+//   --ops M                     number of records, default 1000000
+//   --n N                       array size for range traces, default 2^20
+//   --mix A:S:U:Q:P             relative weights of add, set, update, query, pop
+//   --index uniform|zipf:S|hotspot:FRAC:PROB
+//   --query uniform|short:LEN   query endpoints uniform, or length uniform in [1, LEN]
+//   --values LO:HI              value / delta range, default -1000:1000
+//   --seed S
+
+static std::vector<std::string> split(const std::string& s) {
+    std::vector<std::string> parts;
+    std::stringstream ss(s);
+    std::string part;
+    while (std::getline(ss, part, ':')) parts.push_back(part);
+    return parts;
+}
+
+// stoul without the silent narrowing to 32 bits
+static uint32_t parse_u32(const std::string& val, const char* what) {
+    unsigned long long v = std::stoull(val);
+    if (val.find('-') != std::string::npos || v > std::numeric_limits<uint32_t>::max()) {
+        throw std::out_of_range(std::string(what) + " must be in [0, 2^32 - 1]");
+    }
+    return static_cast<uint32_t>(v);
+}
+
+static void usage(const char* prog) {
+    std::cerr << "usage: " << prog << " <out> [--kind range|sequence] [--ops M] [--n N] [--mix A:S:U:Q:P]"
+              << " [--index uniform|zipf:S|hotspot:FRAC:PROB] [--query uniform|short:LEN] [--values LO:HI] [--seed S]\n";
+}
+
+int main(int argc, char** argv) {
+    using namespace std;
+    if (argc < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+    TraceSpec spec;
+    try {
+        for (int i = 2; i < argc; i += 2) {
+            string key = argv[i];
+            if (i + 1 == argc) throw invalid_argument("missing value for " + key);
+            string val = argv[i + 1];
+            if (val.empty()) throw invalid_argument("empty value for " + key);
+            vector<string> p = split(val);
+            if (key == "--kind") {
+                if (val != "range" && val != "sequence") throw invalid_argument("--kind must be range or sequence");
+                spec.kind = val == "range" ? TraceKind::Range : TraceKind::Sequence;
+            } else if (key == "--ops") {
+                spec.ops = stoull(val);
+            } else if (key == "--n") {
+                spec.array_size = parse_u32(val, "--n");
+            } else if (key == "--mix") {
+                if (p.size() != OP_KINDS) throw invalid_argument("--mix needs five weights");
+                for (int k = 0; k < OP_KINDS; ++k) spec.weight[k] = stod(p[k]);
+            } else if (key == "--index") {
+                spec.index_dist = p[0];
+                if (p[0] == "zipf" && p.size() > 1) spec.zipf_s = stod(p[1]);
+                if (p[0] == "hotspot" && p.size() > 1) spec.hot_frac = stod(p[1]);
+                if (p[0] == "hotspot" && p.size() > 2) spec.hot_prob = stod(p[2]);
+            } else if (key == "--query") {
+                spec.query_len = p[0];
+                if (p.size() > 1) spec.max_query_len = parse_u32(p[1], "--query LEN");
+            } else if (key == "--values") {
+                if (p.size() != 2) throw invalid_argument("--values needs LO:HI");
+                spec.value_lo = stoll(p[0]);
+                spec.value_hi = stoll(p[1]);
+            } else if (key == "--seed") {
+                spec.seed = stoull(val);
+            } else {
+                throw invalid_argument("unknown option " + key);
+            }
+        }
+        generate_trace(spec, argv[1]);
+    } catch (const exception& e) {
+        cerr << e.what() << "\n";
+        usage(argv[0]);
+        return 2;
+    }
+    cout << "wrote " << spec.ops << " records to " << argv[1] << "\n";
+    return 0;
+}
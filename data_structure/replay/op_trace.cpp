@@ -0,0 +1,335 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <thread>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <exception>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Binary operation trace: a 32-byte header followed by fixed-width 16-byte records.
+//
+//   op       a                       b
+//   Add      index  / -              delta / pushed value
+//   Set      index                   value
+//   Update   index                   v: a[index] = max(a[index], v)
+//   Query    l      / 0 min, 1 head  r     / -
+//   Pop      -                       -
+//
+// Range traces (SegmentTree, SqrtDecomposition, Fenwick) use Add/Set/Update/Query over an
+// array of `array_size` zeros; sequence traces (MQueue, MQueue2, MaxStack) use Add/Query/Pop.
+// Records are little-endian host structs: traces are meant to be replayed on the machine kind
+// that wrote them.
+
+enum class Op : uint8_t { Add = 0, Set = 1, Update = 2, Query = 3, Pop = 4 };
+constexpr int OP_KINDS = 5;
+inline const char* op_name(Op op) {
+    static const char* names[OP_KINDS] = {"add", "set", "update", "query", "pop"};
+    return names[static_cast<int>(op)];
+}
+
+enum class TraceKind : uint16_t { Range = 0, Sequence = 1 };
+
+struct OpRecord {
+    Op op;
+    uint8_t pad[3];
+    int32_t a;
+    int64_t b;
+};
+static_assert(sizeof(OpRecord) == 16, "OpRecord must stay 16 bytes");
+
+struct TraceHeader {
+    char magic[8];
+    uint32_t version;
+    uint16_t record_size;
+    TraceKind kind;
+    uint64_t array_size;
+    uint64_t count;
+};
+static_assert(sizeof(TraceHeader) == 32, "TraceHeader must stay 32 bytes");
+
+constexpr char TRACE_MAGIC[8] = {'D', 'S', 'T', 'R', 'A', 'C', 'E', '\0'};
+constexpr uint32_t TRACE_VERSION = 1;
+
+inline OpRecord make_op(Op op, int32_t a = 0, int64_t b = 0) {
+    OpRecord r{};
+    r.op = op;
+    r.a = a;
+    r.b = b;
+    return r;
+}
+
+// buffered append-only writer; the record count is patched into the header on close()
+class OpTraceWriter {
+private:
+    FILE* file = nullptr;
+    TraceHeader header{};
+    std::vector<OpRecord> buffer;
+
+    void drain() {
+        if (!buffer.empty() && fwrite(buffer.data(), sizeof(OpRecord), buffer.size(), file) != buffer.size()) {
+            throw std::runtime_error("OpTraceWriter: write failed");
+        }
+        buffer.clear();
+    }
+
+public:
+    OpTraceWriter(const std::string& path, TraceKind kind, uint64_t array_size) {
+        file = fopen(path.c_str(), "wb");
+        if (!file) throw std::runtime_error("OpTraceWriter: cannot open " + path);
+        std::memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+        header.version = TRACE_VERSION;
+        header.record_size = sizeof(OpRecord);
+        header.kind = kind;
+        header.array_size = array_size;
+        if (fwrite(&header, sizeof(header), 1, file) != 1) throw std::runtime_error("OpTraceWriter: write failed");
+        buffer.reserve(1 << 16);
+    }
+
+    OpTraceWriter(const OpTraceWriter&) = delete;
+    OpTraceWriter& operator=(const OpTraceWriter&) = delete;
+    ~OpTraceWriter() {
+        try { close(); } catch (...) {}
+    }
+
+    void append(const OpRecord& r) {
+        buffer.push_back(r);
+        ++header.count;
+        if (buffer.size() == buffer.capacity()) drain();
+    }
+
+    uint64_t count() const { return header.count; }
+
+    void close() {
+        if (!file) return;
+        drain();
+        bool ok = fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+        ok = fclose(file) == 0 && ok;
+        file = nullptr;
+        if (!ok) throw std::runtime_error("OpTraceWriter: cannot finalize trace");
+    }
+};
+
+// Streams a trace through two memory-mapped windows: while the caller consumes window k,
+// a helper thread maps window k + 1 and faults its pages in, and window k is unmapped as
+// soon as it is done. At most two windows are resident, so traces may exceed RAM.
+class OpTraceReader {
+private:
+    struct Window {
+        void* map = nullptr;
+        size_t map_len = 0;
+        const OpRecord* records = nullptr;
+        uint64_t count = 0;
+    };
+
+    int fd = -1;
+    TraceHeader header{};
+    uint64_t window_records;
+
+    Window map_window(uint64_t first) const {
+        static const uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        Window w;
+        w.count = std::min(window_records, header.count - first);
+        uint64_t offset = sizeof(TraceHeader) + first * sizeof(OpRecord);
+        uint64_t aligned = offset & ~(page - 1);
+        w.map_len = offset + w.count * sizeof(OpRecord) - aligned;
+        w.map = mmap(nullptr, w.map_len, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(aligned));
+        if (w.map == MAP_FAILED) throw std::runtime_error("OpTraceReader: mmap failed");
+        madvise(w.map, w.map_len, MADV_SEQUENTIAL);
+        w.records = reinterpret_cast<const OpRecord*>(static_cast<const char*>(w.map) + (offset - aligned));
+        return w;
+    }
+
+    // touch one byte per page so the consumer never stalls on a fault
+    static void warm(const Window& w) {
+        madvise(w.map, w.map_len, MADV_WILLNEED);
+        const volatile char* p = static_cast<const char*>(w.map);
+        char sink = 0;
+        for (size_t i = 0; i < w.map_len; i += 4096) sink ^= p[i];
+        (void)sink;
+    }
+
+public:
+    // window_bytes: size of each of the two mapped windows
+    explicit OpTraceReader(const std::string& path, uint64_t window_bytes = uint64_t(64) << 20)
+        : window_records(std::max<uint64_t>(1, window_bytes / sizeof(OpRecord))) {
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("OpTraceReader: cannot open " + path);
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+            ::close(fd);
+            throw std::runtime_error("OpTraceReader: cannot read header of " + path);
+        }
+        if (std::memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0 || header.version != TRACE_VERSION ||
+            header.record_size != sizeof(OpRecord)) {
+            ::close(fd);
+            throw std::runtime_error("OpTraceReader: " + path + " is not a version 1 trace");
+        }
+        if (static_cast<uint64_t>(st.st_size) < sizeof(TraceHeader) + header.count * sizeof(OpRecord)) {
+            ::close(fd);
+            throw std::runtime_error("OpTraceReader: " + path + " is truncated");
+        }
+    }
+
+    OpTraceReader(const OpTraceReader&) = delete;
+    OpTraceReader& operator=(const OpTraceReader&) = delete;
+    ~OpTraceReader() {
+        if (fd >= 0) ::close(fd);
+    }
+
+    TraceKind kind() const { return header.kind; }
+    uint64_t array_size() const { return header.array_size; }
+    uint64_t count() const { return header.count; }
+
+    // f(const OpRecord* records, uint64_t count) once per window, in trace order
+    template <typename F>
+    void for_each_window(F f) const {
+        if (header.count == 0) return;
+        Window cur = map_window(0);
+        warm(cur);
+        for (uint64_t first = 0;;) {
+            Window next;
+            std::exception_ptr load_error;
+            std::thread loader;
+            uint64_t next_first = first + cur.count;
+            if (next_first < header.count) {
+                loader = std::thread([&] {
+                    try {
+                        next = map_window(next_first);
+                        warm(next);
+                    } catch (...) {
+                        load_error = std::current_exception();
+                    }
+                });
+            }
+            try {
+                f(cur.records, cur.count);
+            } catch (...) {
+                if (loader.joinable()) loader.join();
+                munmap(cur.map, cur.map_len);
+                if (next.map) munmap(next.map, next.map_len);
+                throw;
+            }
+            munmap(cur.map, cur.map_len);
+            if (!loader.joinable()) break;
+            loader.join();
+            if (load_error) std::rethrow_exception(load_error);
+            first = next_first;
+            cur = next;
+        }
+    }
+};
+
+// Synthetic trace parameters. Op weights are relative; a sequence trace never pops or
+// queries an empty structure (those draws become adds).
+struct TraceSpec {
+    TraceKind kind = TraceKind::Range;
+    uint64_t ops = 1000000;
+    uint32_t array_size = 1 << 20;
+    double weight[OP_KINDS] = {1, 1, 1, 1, 1};   // indexed by Op
+    // index distribution: "uniform", "zipf" (skew `zipf_s`, hot keys at low indices),
+    // or "hotspot" (`hot_prob` of the accesses go to the first `hot_frac` of the array)
+    std::string index_dist = "uniform";
+    double zipf_s = 1.0;
+    double hot_frac = 0.01;
+    double hot_prob = 0.9;
+    // query length: "uniform" (both endpoints uniform) or "short" (length uniform in [1, max_query_len])
+    std::string query_len = "uniform";
+    uint32_t max_query_len = 64;
+    int64_t value_lo = -1000;
+    int64_t value_hi = 1000;
+    uint64_t seed = 12345;
+};
+
+class IndexSampler {
+private:
+    const TraceSpec& spec;
+    std::uniform_real_distribution<double> unit{0.0, 1.0};
+
+public:
+    explicit IndexSampler(const TraceSpec& s) : spec(s) {
+        if (s.index_dist != "uniform" && s.index_dist != "zipf" && s.index_dist != "hotspot") {
+            throw std::invalid_argument("TraceSpec: unknown index distribution " + s.index_dist);
+        }
+        if (s.query_len != "uniform" && s.query_len != "short") {
+            throw std::invalid_argument("TraceSpec: unknown query length distribution " + s.query_len);
+        }
+    }
+
+    template <typename RNG>
+    uint32_t operator()(RNG& rng) {
+        const double n = spec.array_size;
+        double u = unit(rng);
+        double x;
+        if (spec.index_dist == "zipf") {
+            // inverse CDF of the continuous power law on [1, n + 1)
+            if (std::fabs(spec.zipf_s - 1.0) < 1e-9) {
+                x = std::pow(n + 1, u) - 1;
+            } else {
+                double t = 1 - spec.zipf_s;
+                x = std::pow((std::pow(n + 1, t) - 1) * u + 1, 1 / t) - 1;
+            }
+        } else if (spec.index_dist == "hotspot") {
+            double hot = std::max(1.0, std::floor(n * spec.hot_frac));
+            x = unit(rng) < spec.hot_prob ? u * hot : hot + u * (n - hot);
+        } else {
+            x = u * n;
+        }
+        return static_cast<uint32_t>(std::min(n - 1, std::max(0.0, std::floor(x))));
+    }
+};
+
+inline void generate_trace(const TraceSpec& spec, const std::string& path) {
+    if (spec.kind == TraceKind::Range && spec.array_size == 0) throw std::invalid_argument("TraceSpec: range traces need array_size > 0");
+    if (spec.array_size > static_cast<uint32_t>(INT32_MAX)) throw std::invalid_argument("TraceSpec: array_size must fit in int32");
+    if (spec.value_lo > spec.value_hi) throw std::invalid_argument("TraceSpec: empty value range");
+    std::mt19937_64 rng(spec.seed);
+    bool allowed[OP_KINDS] = {true, true, true, true, true};
+    if (spec.kind == TraceKind::Range) allowed[static_cast<int>(Op::Pop)] = false;
+    else allowed[static_cast<int>(Op::Set)] = allowed[static_cast<int>(Op::Update)] = false;
+    std::vector<double> w(OP_KINDS);
+    for (int i = 0; i < OP_KINDS; ++i) w[i] = allowed[i] ? std::max(0.0, spec.weight[i]) : 0.0;
+    std::discrete_distribution<int> pick(w.begin(), w.end());
+    std::uniform_int_distribution<int64_t> value(spec.value_lo, spec.value_hi);
+    IndexSampler index(spec);
+
+    OpTraceWriter out(path, spec.kind, spec.kind == TraceKind::Range ? spec.array_size : 0);
+    uint64_t live = 0;   // current sequence length
+    for (uint64_t i = 0; i < spec.ops; ++i) {
+        Op op = static_cast<Op>(pick(rng));
+        if (spec.kind == TraceKind::Sequence) {
+            if (op != Op::Add && live == 0) op = Op::Add;
+            if (op == Op::Add) {
+                out.append(make_op(Op::Add, 0, value(rng)));
+                ++live;
+            } else if (op == Op::Pop) {
+                out.append(make_op(Op::Pop));
+                --live;
+            } else {
+                out.append(make_op(Op::Query, static_cast<int32_t>(rng() & 1)));
+            }
+            continue;
+        }
+        if (op == Op::Query) {
+            uint32_t l = index(rng), r;
+            if (spec.query_len == "short") {
+                r = static_cast<uint32_t>(std::min<uint64_t>(spec.array_size - 1, l + rng() % std::max<uint32_t>(1, spec.max_query_len)));
+            } else {
+                r = index(rng);
+                if (l > r) std::swap(l, r);
+            }
+            out.append(make_op(Op::Query, static_cast<int32_t>(l), r));
+        } else {
+            out.append(make_op(op, static_cast<int32_t>(index(rng)), value(rng)));
+        }
+    }
+    out.close();
+}
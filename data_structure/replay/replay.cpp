@@ -0,0 +1,50 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include "replay_driver.cpp"
+
+// replay a binary op trace (see gen_trace.cpp) against one structure.
+// build: g++ -std=c++17 -O2 -pthread replay.cpp -o replay
+// usage: replay <structure> <trace> [--check] [--sample K] [--window MiB]
+//   structure: segtree | sqrt | fenwick (range traces), mqueue | mqueue2 | maxstack (sequence traces)
+
+template <typename DS>
+int run(const OpTraceReader& trace, const ReplayOptions& opt) {
+    ReplayReport rep = replay<DS>(trace, opt);
+    rep.print(std::cout);
+    return rep.mismatches == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    using namespace std;
+    if (argc < 3) {
+        cerr << "usage: " << argv[0] << " <segtree|sqrt|fenwick|mqueue|mqueue2|maxstack> <trace> [--check] [--sample K] [--window MiB]\n";
+        return 2;
+    }
+    string name = argv[1];
+    ReplayOptions opt;
+    for (int i = 3; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--check") opt.check = true;
+        else if (arg == "--sample" && i + 1 < argc) opt.sample_every = static_cast<uint32_t>(atoi(argv[++i]));
+        else if (arg == "--window" && i + 1 < argc) opt.window_bytes = static_cast<uint64_t>(atoll(argv[++i])) << 20;
+        else {
+            cerr << "unknown argument " << arg << "\n";
+            return 2;
+        }
+    }
+    try {
+        OpTraceReader trace(argv[2], opt.window_bytes);
+        if (name == "segtree") return run<SegmentTree<trace_value>>(trace, opt);
+        if (name == "sqrt") return run<SqrtDecomposition<trace_value>>(trace, opt);
+        if (name == "fenwick") return run<Fenwick<trace_value>>(trace, opt);
+        if (name == "mqueue") return run<MQueue<trace_value>>(trace, opt);
+        if (name == "mqueue2") return run<MQueue2<trace_value>>(trace, opt);
+        if (name == "maxstack") return run<MaxStack>(trace, opt);
+        cerr << "unknown structure " << name << "\n";
+        return 2;
+    } catch (const exception& e) {
+        cerr << e.what() << "\n";
+        return 2;
+    }
+}
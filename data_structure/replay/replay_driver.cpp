@@ -0,0 +1,363 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <memory>
+#include <set>
+#include <utility>
+#include <string>
+#include <chrono>
+#include <limits>
+#include <ostream>
+#include <iomanip>
+#include <stdexcept>
+#include <algorithm>
+#include "../instrumentation.cpp"
+#include "../tree/segment_tree/basic.cpp"
+#include "../tree/sqrt_decomposition.cpp"
+#include "../tree/fenwick_tree.cpp"
+#include "../linear/mqueue_single_queue.cpp"
+#include "../linear/mStack.cpp"
+#include "../linear/mqueue_2stack.cpp"
+#include "op_trace.cpp"
+
+// Replays an OpTraceReader trace against one structure, chosen at compile time through
+// Adapter<DS>, optionally checking every result against a naive reference model.
+
+using trace_value = int64_t;
+
+// Adapter<DS>: kind of trace it accepts, a Model type, and apply() returning the query
+// result (0 for updates). Invalid records throw, the same way in the adapter and its model.
+template <typename DS>
+struct Adapter;
+
+inline void check_range_record(const OpRecord& r, int64_t n) {
+    if (r.op == Op::Pop) throw std::invalid_argument("pop is not a range operation");
+    if (r.op == Op::Query) {
+        if (r.a < 0 || r.a > r.b || r.b >= n) throw std::out_of_range("query range out of bounds");
+    } else if (r.a < 0 || r.a >= n) {
+        throw std::out_of_range("index out of range");
+    }
+}
+
+inline void check_sequence_record(const OpRecord& r) {
+    if (r.op == Op::Set || r.op == Op::Update) throw std::invalid_argument("set/update are not sequence operations");
+}
+
+// naive array: O(r - l) queries
+struct RangeModel {
+    std::vector<trace_value> a;
+    explicit RangeModel(uint64_t n) : a(n, 0) {}
+    trace_value apply(const OpRecord& r) {
+        check_range_record(r, static_cast<int64_t>(a.size()));
+        switch (r.op) {
+        case Op::Add: a[r.a] += r.b; return 0;
+        case Op::Set: a[r.a] = r.b; return 0;
+        case Op::Update: a[r.a] = std::max(a[r.a], r.b); return 0;
+        default: {
+            trace_value s = 0;
+            for (int64_t i = r.a; i <= r.b; ++i) s += a[i];
+            return s;
+        }
+        }
+    }
+};
+
+// FIFO with a multiset for the minimum
+struct QueueModel {
+    std::deque<trace_value> q;
+    std::multiset<trace_value> values;
+    explicit QueueModel(uint64_t) {}
+    trace_value apply(const OpRecord& r) {
+        check_sequence_record(r);
+        if (r.op == Op::Add) {
+            q.push_back(r.b);
+            values.insert(r.b);
+            return 0;
+        }
+        if (q.empty()) throw std::runtime_error("empty queue");
+        if (r.op == Op::Query) return r.a == 0 ? *values.begin() : q.front();
+        values.erase(values.find(q.front()));
+        q.pop_front();
+        return 0;
+    }
+};
+
+// LIFO with a multiset for the maximum
+struct StackModel {
+    std::vector<trace_value> s;
+    std::multiset<trace_value> values;
+    explicit StackModel(uint64_t) {}
+    trace_value apply(const OpRecord& r) {
+        check_sequence_record(r);
+        if (r.op == Op::Add) {
+            s.push_back(r.b);
+            values.insert(r.b);
+            return 0;
+        }
+        if (s.empty()) throw std::runtime_error("empty stack");
+        if (r.op == Op::Query) return r.a == 0 ? *values.rbegin() : s.back();
+        values.erase(values.find(s.back()));
+        s.pop_back();
+        return 0;
+    }
+};
+
+template <>
+struct Adapter<SegmentTree<trace_value>> {
+    static constexpr TraceKind kind = TraceKind::Range;
+    static constexpr const char* name = "SegmentTree";
+    using Model = RangeModel;
+    SegmentTree<trace_value> ds;
+    int64_t n;
+    explicit Adapter(uint64_t size) : ds(vec<trace_value>(size)), n(static_cast<int64_t>(size)) {}
+    trace_value apply(const OpRecord& r) {
+        check_range_record(r, n);
+        switch (r.op) {
+        case Op::Add: ds.add(r.a, r.b); return 0;
+        case Op::Set: ds.set(r.a, r.b); return 0;
+        case Op::Update: {
+            trace_value v = r.b;
+            ds.update(r.a, [v](const trace_value& old) { return std::max(old, v); });
+            return 0;
+        }
+        default: return ds.query(r.a, static_cast<int>(r.b));
+        }
+    }
+};
+
+template <>
+struct Adapter<SqrtDecomposition<trace_value>> {
+    static constexpr TraceKind kind = TraceKind::Range;
+    static constexpr const char* name = "SqrtDecomposition";
+    using Model = RangeModel;
+    SqrtDecomposition<trace_value> ds;
+    int64_t n;
+    explicit Adapter(uint64_t size) : ds(static_cast<int>(size)), n(static_cast<int64_t>(size)) {}
+    trace_value apply(const OpRecord& r) {
+        check_range_record(r, n);
+        switch (r.op) {
+        case Op::Add: ds.add(r.a, r.b); return 0;
+        case Op::Set: ds.set(r.a, r.b); return 0;
+        case Op::Update: {
+            trace_value cur = ds.query(r.a, r.a);
+            if (r.b > cur) ds.add(r.a, r.b - cur);
+            return 0;
+        }
+        default: return ds.query(r.a, static_cast<int>(r.b));
+        }
+    }
+};
+
+template <>
+struct Adapter<Fenwick<trace_value>> {
+    static constexpr TraceKind kind = TraceKind::Range;
+    static constexpr const char* name = "Fenwick";
+    using Model = RangeModel;
+    Fenwick<trace_value> ds;
+    int64_t n;
+    explicit Adapter(uint64_t size) : ds(vec<trace_value>(size)), n(static_cast<int64_t>(size)) {}
+    trace_value apply(const OpRecord& r) {
+        check_range_record(r, n);
+        switch (r.op) {
+        case Op::Add: ds.add(r.a, r.b); return 0;
+        case Op::Set: ds.add(r.a, r.b - ds.query(r.a, r.a)); return 0;
+        case Op::Update: {
+            trace_value cur = ds.query(r.a, r.a);
+            if (r.b > cur) ds.add(r.a, r.b - cur);
+            return 0;
+        }
+        default: return ds.query(r.a, static_cast<int>(r.b));
+        }
+    }
+};
+
+template <>
+struct Adapter<MQueue<trace_value>> {
+    static constexpr TraceKind kind = TraceKind::Sequence;
+    static constexpr const char* name = "MQueue";
+    using Model = QueueModel;
+    MQueue<trace_value> ds;
+    explicit Adapter(uint64_t) {}
+    trace_value apply(const OpRecord& r) {
+        check_sequence_record(r);
+        switch (r.op) {
+        case Op::Add: ds.add(r.b); return 0;
+        case Op::Pop: ds.pop(); return 0;
+        default: return r.a == 0 ? ds.min() : ds.head();
+        }
+    }
+};
+
+template <>
+struct Adapter<MQueue2<trace_value>> {
+    static constexpr TraceKind kind = TraceKind::Sequence;
+    static constexpr const char* name = "MQueue2";
+    using Model = QueueModel;
+    MQueue2<trace_value> ds;
+    explicit Adapter(uint64_t) {}
+    trace_value apply(const OpRecord& r) {
+        check_sequence_record(r);
+        switch (r.op) {
+        case Op::Add: ds.add(r.b); return 0;
+        case Op::Pop: ds.pop(); return 0;
+        default: return r.a == 0 ? ds.min() : ds.head();
+        }
+    }
+};
+
+// MaxStack holds int and does not check for emptiness itself
+template <>
+struct Adapter<MaxStack> {
+    static constexpr TraceKind kind = TraceKind::Sequence;
+    static constexpr const char* name = "MaxStack";
+    using Model = StackModel;
+    MaxStack ds;
+    uint64_t live = 0;
+    explicit Adapter(uint64_t) {}
+    trace_value apply(const OpRecord& r) {
+        check_sequence_record(r);
+        if (r.op == Op::Add) {
+            if (r.b < std::numeric_limits<int>::min() || r.b > std::numeric_limits<int>::max()) {
+                throw std::out_of_range("MaxStack: value does not fit in int");
+            }
+            ds.push(static_cast<int>(r.b));
+            ++live;
+            return 0;
+        }
+        if (live == 0) throw std::runtime_error("MaxStack: empty stack");
+        if (r.op == Op::Query) return r.a == 0 ? ds.max() : ds.top();
+        ds.pop();
+        --live;
+        return 0;
+    }
+};
+
+// latency histogram with 16 linear sub-buckets per power of two (about 6% resolution)
+struct LatencyHistogram {
+    static constexpr int SUB_BITS = 4;
+    static constexpr int BUCKETS = 64 << SUB_BITS;
+    std::vector<uint64_t> bucket = std::vector<uint64_t>(BUCKETS, 0);
+    uint64_t count = 0;
+    uint64_t max_ns = 0;
+
+    static int index(uint64_t ns) {
+        if (ns < (uint64_t(1) << SUB_BITS)) return static_cast<int>(ns);
+        int msb = 63 - __builtin_clzll(ns);
+        int sub = static_cast<int>((ns >> (msb - SUB_BITS)) & ((1 << SUB_BITS) - 1));
+        return ((msb - SUB_BITS + 1) << SUB_BITS) + sub;
+    }
+
+    // largest value that lands in bucket i
+    static uint64_t upper(int i) {
+        if (i < (1 << SUB_BITS)) return static_cast<uint64_t>(i);
+        int msb = (i >> SUB_BITS) + SUB_BITS - 1;
+        uint64_t sub = static_cast<uint64_t>(i & ((1 << SUB_BITS) - 1));
+        return (((uint64_t(1) << SUB_BITS | sub) + 1) << (msb - SUB_BITS)) - 1;
+    }
+
+    void record(uint64_t ns) {
+        ++bucket[index(ns)];
+        ++count;
+        max_ns = std::max(max_ns, ns);
+    }
+
+    // q in [0, 1]; reported as the upper edge of the bucket holding the q-quantile
+    uint64_t percentile(double q) const {
+        if (count == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += bucket[i];
+            if (seen >= rank) return std::min(upper(i), max_ns);
+        }
+        return max_ns;
+    }
+};
+
+struct ReplayOptions {
+    bool check = false;             // run the reference model alongside
+    uint32_t sample_every = 16;     // time one op in sample_every, 0 disables latency
+    uint64_t window_bytes = uint64_t(64) << 20;
+};
+
+struct ReplayReport {
+    std::string structure;
+    uint64_t ops = 0;
+    double seconds = 0;
+    uint64_t per_op[OP_KINDS] = {};
+    uint64_t errors = 0;            // records the structure rejected
+    bool checked = false;
+    uint64_t mismatches = 0;
+    uint64_t first_mismatch = std::numeric_limits<uint64_t>::max();
+    uint64_t checksum = 0;          // hash of the query results, comparable across structures
+    LatencyHistogram latency[OP_KINDS];
+
+    double ops_per_sec() const { return seconds > 0 ? ops / seconds : 0; }
+
+    void print(std::ostream& os) const {
+        os << structure << ": " << ops << " ops in " << std::fixed << std::setprecision(3) << seconds << " s, "
+           << std::setprecision(0) << ops_per_sec() << " ops/s, checksum " << checksum << ", errors " << errors;
+        if (checked) {
+            os << ", mismatches " << mismatches;
+            if (mismatches) os << " (first at op " << first_mismatch << ")";
+        }
+        os << "\n";
+        for (int k = 0; k < OP_KINDS; ++k) {
+            if (per_op[k] == 0) continue;
+            const LatencyHistogram& h = latency[k];
+            os << "  " << std::left << std::setw(7) << op_name(static_cast<Op>(k)) << std::right << std::setw(12) << per_op[k];
+            if (h.count) {
+                os << "  ns p50 " << h.percentile(0.5) << "  p90 " << h.percentile(0.9) << "  p99 " << h.percentile(0.99)
+                   << "  p99.9 " << h.percentile(0.999) << "  max " << h.max_ns << "  (" << h.count << " sampled)";
+            }
+            os << "\n";
+        }
+    }
+};
+
+template <typename DS>
+ReplayReport replay(const OpTraceReader& trace, const ReplayOptions& opt = ReplayOptions()) {
+    using A = Adapter<DS>;
+    using clk = std::chrono::steady_clock;
+    if (trace.kind() != A::kind) throw std::invalid_argument(std::string("replay: trace kind does not match ") + A::name);
+    A adapter(trace.array_size());
+    std::unique_ptr<typename A::Model> model;
+    if (opt.check) model.reset(new typename A::Model(trace.array_size()));
+
+    ReplayReport rep;
+    rep.structure = A::name;
+    rep.checked = opt.check;
+    uint32_t countdown = opt.sample_every;
+    auto start = clk::now();
+    trace.for_each_window([&](const OpRecord* records, uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) {
+            const OpRecord& r = records[i];
+            int k = static_cast<int>(r.op);
+            if (k >= OP_KINDS) throw std::runtime_error("replay: corrupt record at op " + std::to_string(rep.ops));
+            trace_value got = 0;
+            bool threw = false;
+            if (countdown != 0 && --countdown == 0) {
+                countdown = opt.sample_every;
+                auto t0 = clk::now();
+                try { got = adapter.apply(r); } catch (const std::exception&) { threw = true; }
+                rep.latency[k].record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clk::now() - t0).count()));
+            } else {
+                try { got = adapter.apply(r); } catch (const std::exception&) { threw = true; }
+            }
+            if (model) {
+                trace_value want = 0;
+                bool model_threw = false;
+                try { want = model->apply(r); } catch (const std::exception&) { model_threw = true; }
+                if (threw != model_threw || (!threw && got != want)) {
+                    if (rep.mismatches++ == 0) rep.first_mismatch = rep.ops;
+                }
+            }
+            if (threw) ++rep.errors;
+            else if (r.op == Op::Query) rep.checksum = rep.checksum * 1000003 + static_cast<uint64_t>(got);
+            ++rep.per_op[k];
+            ++rep.ops;
+        }
+    });
+    rep.seconds = std::chrono::duration<double>(clk::now() - start).count();
+    return rep;
+}
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include "replay_driver.cpp"
+
+int main() {
+    using namespace std;
+    const string path = "test_op_trace.bin";
+    // windows of 4 KiB force many remaps of the two-window reader
+    ReplayOptions opt;
+    opt.check = true;
+    opt.sample_every = 3;
+    opt.window_bytes = 4096;
+
+    // writer / reader round trip
+    {
+        OpTraceWriter w(path, TraceKind::Range, 10);
+        for (int i = 0; i < 1000; ++i) w.append(make_op(Op::Add, i % 10, i));
+        w.close();
+        OpTraceReader r(path, 4096);
+        assert(r.count() == 1000 && r.array_size() == 10 && r.kind() == TraceKind::Range);
+        uint64_t seen = 0;
+        r.for_each_window([&](const OpRecord* rec, uint64_t count) {
+            for (uint64_t i = 0; i < count; ++i, ++seen) {
+                assert(rec[i].op == Op::Add && rec[i].a == static_cast<int32_t>(seen % 10) && rec[i].b == static_cast<int64_t>(seen));
+            }
+        });
+        assert(seen == 1000);
+    }
+
+    // range structures agree with the model and with each other
+    TraceSpec spec;
+    spec.ops = 20000;
+    spec.array_size = 500;
+    spec.index_dist = "zipf";
+    generate_trace(spec, path);
+    {
+        OpTraceReader trace(path, opt.window_bytes);
+        ReplayReport seg = replay<SegmentTree<trace_value>>(trace, opt);
+        ReplayReport sq = replay<SqrtDecomposition<trace_value>>(trace, opt);
+        ReplayReport fw = replay<Fenwick<trace_value>>(trace, opt);
+        for (const ReplayReport* rep : {&seg, &sq, &fw}) {
+            assert(rep->ops == spec.ops && rep->mismatches == 0 && rep->errors == 0);
+            assert(rep->checksum == seg.checksum);
+        }
+        assert(seg.per_op[static_cast<int>(Op::Pop)] == 0);
+        assert(seg.latency[static_cast<int>(Op::Query)].count > 0);
+        bool threw = false;
+        try { replay<MQueue2<trace_value>>(trace, opt); } catch (const invalid_argument&) { threw = true; }
+        assert(threw);
+    }
+
+    // sequence structures
+    spec.kind = TraceKind::Sequence;
+    spec.weight[static_cast<int>(Op::Pop)] = 2;
+    generate_trace(spec, path);
+    {
+        OpTraceReader trace(path, opt.window_bytes);
+        ReplayReport mq = replay<MQueue<trace_value>>(trace, opt);
+        ReplayReport mq2 = replay<MQueue2<trace_value>>(trace, opt);
+        ReplayReport ms = replay<MaxStack>(trace, opt);
+        for (const ReplayReport* rep : {&mq, &mq2, &ms}) {
+            assert(rep->ops == spec.ops && rep->mismatches == 0 && rep->errors == 0);
+        }
+        assert(mq.checksum == mq2.checksum);
+    }
+
+    // invalid records are rejected by structure and model alike
+    {
+        OpTraceWriter w(path, TraceKind::Sequence, 0);
+        w.append(make_op(Op::Pop));
+        w.append(make_op(Op::Add, 0, 5));
+        w.append(make_op(Op::Query, 0));
+        w.close();
+        OpTraceReader trace(path);
+        ReplayReport ms = replay<MaxStack>(trace, opt);
+        assert(ms.errors == 1 && ms.mismatches == 0);
+    }
+
+    // the histogram's bucket edges bound the values they hold
+    LatencyHistogram h;
+    for (uint64_t v : {0ull, 7ull, 15ull, 16ull, 17ull, 100ull, 1000ull, 123456789ull}) {
+        int i = LatencyHistogram::index(v);
+        assert(v <= LatencyHistogram::upper(i));
+        assert(i == 0 || LatencyHistogram::upper(i - 1) < v);
+    }
+    for (uint64_t v = 1; v <= 1000; ++v) h.record(v);
+    assert(h.percentile(0.5) >= 500 && h.percentile(0.5) <= 530);
+    assert(h.percentile(1.0) == 1000);
+
+    remove(path.c_str());
+    cout << "Op trace replay tests passed" << endl;
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include "external_sqrt_decomposition.cpp"
+
+// throughput of ExternalSqrtDecomposition against cache size, with the file 4x..32x the cache.
+// build: g++ -std=c++17 -O2 -pthread bench_external_sqrt_decomposition.cpp
+// usage: ./a.out [log2 n] [file]   (default 2^25 int64 = 256 MiB)
+using clk = std::chrono::steady_clock;
+
+template <typename F>
+double ops_per_sec(int ops, F f) {
+    auto start = clk::now();
+    f();
+    return ops / std::chrono::duration<double>(clk::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    using namespace std;
+    const int log_n = argc > 1 ? atoi(argv[1]) : 25;
+    const string path = argc > 2 ? argv[2] : "bench_external_sqrt_decomposition.bin";
+    const int64_t n = int64_t(1) << log_n;
+    const int Q = 200000;
+    const int64_t file_mb = n * static_cast<int64_t>(sizeof(long long)) >> 20;
+
+    cout << "n = " << n << " (" << file_mb << " MiB on disk)\n" << fixed << setprecision(0);
+    for (int64_t cache_mb : {file_mb / 32, file_mb / 16, file_mb / 8, file_mb / 4}) {
+        for (int prefetch : {0, 1}) {
+            mt19937_64 rng(7);
+            ExternalSqrtDecomposition<long long> ext(path, n, cache_mb << 20, [](int64_t i) { return static_cast<long long>(i % 1000); }, prefetch);
+            long long sink = 0;
+            // random ranges, mostly long: two partial blocks each
+            double rand_q = ops_per_sec(Q, [&] {
+                for (int i = 0; i < Q; ++i) {
+                    int64_t l = rng() % n, r = rng() % n;
+                    sink += ext.query(min(l, r), max(l, r));
+                }
+            });
+            double rand_u = ops_per_sec(Q, [&] {
+                for (int i = 0; i < Q; ++i) ext.add(rng() % n, 1);
+            });
+            // sliding window of one block moving forward: the pattern the prefetcher is for
+            const int64_t w = ext.block_length();
+            double seq_q = ops_per_sec(Q, [&] {
+                int64_t step = max<int64_t>(1, (n - w) / Q);
+                for (int i = 0; i < Q; ++i) {
+                    int64_t l = i * step % (n - w);
+                    sink += ext.query(l, l + w - 1);
+                }
+            });
+            ext.flush();
+            auto s = ext.stats();
+            cout << "  cache " << setw(3) << cache_mb << " MiB (" << ext.cache_frames() << " frames), prefetch " << prefetch
+                 << ": random query " << setw(7) << rand_q << "/s, random add " << setw(7) << rand_u
+                 << "/s, sliding query " << setw(8) << seq_q << "/s"
+                 << "  [hits " << s.hits << ", misses " << s.misses << ", prefetched " << s.prefetched
+                 << ", writebacks " << s.writebacks << " in " << s.writeback_batches << " batches]\n";
+            if (sink == 42) cout << "";
+        }
+    }
+    std::remove(path.c_str());
+    return 0;
+}
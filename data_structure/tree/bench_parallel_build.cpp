@@ -0,0 +1,53 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <thread>
+#include "segment_tree/basic.cpp"
+#include "wavelet_matrix.cpp"
+
+// build-time scaling of the static and tree structures on the shared work-stealing runtime: each
+// row resizes the pool with ws::set_num_threads and passes the same count as num_threads.
+// build: g++ -std=c++17 -O2 -pthread bench_parallel_build.cpp && ./a.out [log2 n = 24]
+template <typename F>
+double ms(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    using namespace std;
+    const int n = 1 << (argc > 1 ? atoi(argv[1]) : 24);
+    const int hw = max(1u, thread::hardware_concurrency());
+    vector<int> thread_counts;
+    for (int t = 1; t <= max(hw, 4); t *= 2) thread_counts.push_back(t);
+    if (thread_counts.back() != hw && hw > 4) thread_counts.push_back(hw);
+
+    mt19937 rng(12345);
+    vec<int> a(n);
+    for (auto &x : a) x = static_cast<int>(rng() % 1000000);
+    vec<long long> al(a.begin(), a.end());
+    auto mx = [](const int &x, const int &y){ return x > y ? x : y; };
+    auto add = [](const long long &x, const long long &y){ return x + y; };
+
+    cout << "n = " << n << ", hardware threads: " << hw << "\n" << fixed << setprecision(1);
+    cout << setw(8) << "threads" << setw(22) << "segtree(max) ms" << setw(22) << "sparse ms"
+         << setw(22) << "disjoint ms" << setw(22) << "wavelet ms" << "\n";
+    double base[4] = {0, 0, 0, 0};
+    for (int t : thread_counts) {
+        ws::set_num_threads(t);
+        double r[4];
+        r[0] = ms([&]{ SegmentTree<int> seg(a, mx, 0, t); });
+        r[1] = ms([&]{ SparseTable<int> st(a, mx, t); });
+        r[2] = ms([&]{ DisjointSparseTable<long long> dst(al, add, 0, t); });
+        r[3] = ms([&]{ WaveletMatrix<int> wm(a, t); });
+        cout << setw(8) << t;
+        for (int k = 0; k < 4; ++k) {
+            if (t == 1) base[k] = r[k];
+            cout << setw(12) << setprecision(1) << r[k] << " (x" << setprecision(2) << base[k] / r[k] << ")";
+        }
+        cout << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <limits>
+#include "segment_tree/basic.cpp"
+#include "segment_tree/beats.cpp"
+
+// throughput of SegmentTreeBeats at n = 1e6 and 1e7, against clamping index by index
+// with SegmentTree::update.
+// build: g++ -std=c++17 -O2 bench_segment_tree_beats.cpp
+using clk = std::chrono::steady_clock;
+
+template <typename F>
+double ops_per_sec(int ops, F f) {
+    auto start = clk::now();
+    f();
+    return ops / std::chrono::duration<double>(clk::now() - start).count();
+}
+
+int main() {
+    using namespace std;
+    const int Q = 1000000;
+    for (int n : {1000000, 10000000}) {
+        mt19937 rng(777);
+        vec<int> a(n);
+        for (auto &x : a) x = static_cast<int>(rng() % 1000000000);
+        vector<pair<int,int>> ranges(Q);
+        vector<int> xs(Q);
+        for (int i = 0; i < Q; ++i) {
+            int l = rng() % n, r = rng() % n;
+            ranges[i] = {min(l, r), max(l, r)};
+            xs[i] = static_cast<int>(rng() % 1000000000);
+        }
+        long long sink = 0;
+        auto start = clk::now();
+        SegmentTreeBeats<int, long long> st(a);
+        double build_ms = chrono::duration<double, milli>(clk::now() - start).count();
+
+        cout << "n = " << n << ": build " << fixed << setprecision(0) << build_ms << " ms, "
+             << st.memory_bytes() / double(1 << 20) << " MiB\n";
+        cout << "  ops/s  chmin " << ops_per_sec(Q, [&]{ for (int i = 0; i < Q; ++i) st.chmin(ranges[i].first, ranges[i].second, xs[i]); })
+             << ", chmax " << ops_per_sec(Q, [&]{ for (int i = 0; i < Q; ++i) st.chmax(ranges[i].first, ranges[i].second, xs[i] / 4); })
+             << ", add " << ops_per_sec(Q, [&]{ for (int i = 0; i < Q; ++i) st.add(ranges[i].first, ranges[i].second, (i & 1) ? 3 : -3); })
+             << ", sum " << ops_per_sec(Q, [&]{ for (int i = 0; i < Q; ++i) sink += st.query_sum(ranges[i].first, ranges[i].second); })
+             << ", max " << ops_per_sec(Q, [&]{ for (int i = 0; i < Q; ++i) sink += st.query_max(ranges[i].first, ranges[i].second); })
+             << ", min " << ops_per_sec(Q, [&]{ for (int i = 0; i < Q; ++i) sink += st.query_min(ranges[i].first, ranges[i].second); }) << "\n";
+        // mixed workload: quota clamps interleaved with refills and reads
+        cout << "  ops/s  mixed (40% chmin, 10% chmax, 20% add, 30% query) "
+             << ops_per_sec(Q, [&]{
+                    for (int i = 0; i < Q; ++i) {
+                        int l = ranges[i].first, r = ranges[i].second, k = i % 10;
+                        if (k < 4) st.chmin(l, r, xs[i]);
+                        else if (k < 5) st.chmax(l, r, xs[i] / 8);
+                        else if (k < 7) st.add(l, r, 1);
+                        else sink += st.query_sum(l, r) + st.query_max(l, r);
+                    }
+                }) << "\n";
+
+        // baseline: chmin over ranges of length 1000 one index at a time
+        const int B = 2000, len = 1000;
+        vec<long long> al(a.begin(), a.end());
+        SegmentTree<long long> seg(al);
+        SegmentTreeBeats<int, long long> st2(a);
+        double base = ops_per_sec(B, [&]{
+            for (int i = 0; i < B; ++i) {
+                int l = ranges[i].first % (n - len);
+                long long x = xs[i];
+                for (int j = l; j < l + len; ++j) seg.update(j, [x](const long long &old){ return old < x ? old : x; });
+            }
+        });
+        double beats = ops_per_sec(B, [&]{
+            for (int i = 0; i < B; ++i) {
+                int l = ranges[i].first % (n - len);
+                st2.chmin(l, l + len - 1, xs[i]);
+            }
+        });
+        cout << "  chmin over 1000 elements: SegmentTree::update per index " << base << " ops/s, beats " << beats << " ops/s\n";
+        if (sink == 42) cout << "";
+    }
+    return 0;
+}
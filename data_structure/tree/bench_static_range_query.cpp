@@ -0,0 +1,78 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <limits>
+#include "segment_tree/basic.cpp"
+#include "wavelet_matrix.cpp"
+
+// query latency and memory of the static indexes against SegmentTree.
+// build: g++ -std=c++17 -O2 -pthread bench_static_range_query.cpp
+using clk = std::chrono::steady_clock;
+
+template <typename F>
+double ns_per_op(int ops, F f) {
+    auto start = clk::now();
+    f();
+    return std::chrono::duration<double, std::nano>(clk::now() - start).count() / ops;
+}
+
+template <typename F>
+double ms(F f) {
+    auto start = clk::now();
+    f();
+    return std::chrono::duration<double, std::milli>(clk::now() - start).count();
+}
+
+int main() {
+    using namespace std;
+    const int Q = 1000000;
+    const int threads = max(1u, thread::hardware_concurrency());
+    mt19937 rng(12345);
+    auto mx = [](const int &x, const int &y){ return x > y ? x : y; };
+
+    for (int n : {1 << 16, 1 << 20, 1 << 23}) {
+        vec<int> a(n);
+        for (auto &x : a) x = static_cast<int>(rng() % 1000000);
+        vector<pair<int,int>> qs(Q);
+        for (auto &q : qs) {
+            int l = rng() % n, r = rng() % n;
+            q = {min(l, r), max(l, r)};
+        }
+        long long sink = 0;
+        int base = 1;
+        while (base < n) base <<= 1;
+
+        SegmentTree<int> seg;
+        SparseTable<int> st, st_par;
+        DisjointSparseTable<long long> dst;
+        WaveletMatrix<int> wm, wm_par;
+        vec<long long> al(a.begin(), a.end());
+        SegmentTree<long long> seg_sum;
+
+        cout << "n = " << n << " (" << threads << " threads for parallel build)\n";
+        cout << fixed << setprecision(1);
+        cout << "  build ms: segtree " << ms([&]{ seg = SegmentTree<int>(a, mx, numeric_limits<int>::min()); })
+             << ", sparse " << ms([&]{ st = SparseTable<int>(a, mx); })
+             << ", sparse(par) " << ms([&]{ st_par = SparseTable<int>(a, mx, threads); })
+             << ", disjoint " << ms([&]{ dst = DisjointSparseTable<long long>(al, [](const long long &x, const long long &y){ return x + y; }, 0, threads); })
+             << ", wavelet " << ms([&]{ wm = WaveletMatrix<int>(a); })
+             << ", wavelet(par) " << ms([&]{ wm_par = WaveletMatrix<int>(a, threads); }) << "\n";
+        seg_sum = SegmentTree<long long>(al);
+
+        cout << "  max query ns: segtree " << ns_per_op(Q, [&]{ for (auto &q : qs) sink += seg.query(q.first, q.second); })
+             << ", sparse " << ns_per_op(Q, [&]{ for (auto &q : qs) sink += st.query(q.first, q.second); }) << "\n";
+        cout << "  sum query ns: segtree " << ns_per_op(Q, [&]{ for (auto &q : qs) sink += seg_sum.query(q.first, q.second); })
+             << ", disjoint " << ns_per_op(Q, [&]{ for (auto &q : qs) sink += dst.query(q.first, q.second); }) << "\n";
+        cout << "  wavelet ns: kth " << ns_per_op(Q, [&]{ for (auto &q : qs) sink += wm.kth_smallest(q.first, q.second, (q.second - q.first) / 2); })
+             << ", range_freq " << ns_per_op(Q, [&]{ for (auto &q : qs) sink += wm.range_freq(q.first, q.second, 1000, 500000); }) << "\n";
+        cout << "  memory MiB: segtree " << (2.0 * base * sizeof(int)) / (1 << 20)
+             << ", sparse " << st.memory_bytes() / double(1 << 20)
+             << ", disjoint(int64) " << dst.memory_bytes() / double(1 << 20)
+             << ", wavelet " << wm.memory_bytes() / double(1 << 20)
+             << " (raw " << n * sizeof(int) / double(1 << 20) << ")\n";
+        if (sink == 42) cout << "";
+    }
+    return 0;
+}
@@ -0,0 +1,413 @@
+#include <vector>
+#include <list>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../instrumentation.cpp"
+
+// ExternalSqrtDecomposition: disk-backed SqrtDecomposition for arrays larger than RAM.
+//
+// `raw` lives in a file as page-aligned blocks; only the `blocks` summary array stays resident.
+// Partial-block reads and point updates go through a bounded LRU cache of block frames.
+// A background thread prefetches the neighbours of every block a query touches, and dirty
+// frames are written back in batches (oldest first, sorted by file offset) when one must be evicted.
+// Reads happen outside the cache lock: a frame being loaded is reserved (not ready) meanwhile.
+// The file keeps the array: the destructor flushes, and the OpenExisting constructor reopens it.
+template <typename T>
+class ExternalSqrtDecomposition {
+    static_assert(std::is_trivially_copyable<T>::value, "ExternalSqrtDecomposition: T must be trivially copyable");
+
+public:
+    static constexpr int64_t PAGE = 4096;
+    static_assert(PAGE % sizeof(T) == 0, "ExternalSqrtDecomposition: sizeof(T) must divide the page size");
+
+    struct Stats {
+        uint64_t hits = 0;            // block already resident
+        uint64_t misses = 0;          // synchronous read on the query path
+        uint64_t prefetched = 0;      // blocks loaded by the prefetch thread
+        uint64_t writebacks = 0;      // dirty blocks written
+        uint64_t writeback_batches = 0;
+    };
+
+private:
+    struct Frame {
+        int64_t block = -1;
+        bool dirty = false;
+        bool ready = false;   // false while a load() (query path or prefetch thread) reads it outside the lock
+        T* data = nullptr;
+        std::list<int>::iterator pos;
+    };
+
+    int fd = -1;
+    int64_t num_raw = 0;
+    int64_t block_size = 1;
+    int64_t num_block = 0;
+    int64_t block_bytes = PAGE;
+    int prefetch_distance = 1;
+    int writeback_batch = 16;
+    std::vector<T> blocks;
+
+    std::vector<Frame> frames;
+    std::vector<int> free_frames;
+    std::list<int> lru;                 // ready frames, most recently used first
+    std::vector<int> frame_of;          // block -> frame, -1 if not resident
+    std::vector<char> queued;           // block -> waiting in prefetch_queue
+    std::deque<int64_t> prefetch_queue;
+    std::mutex mu;
+    std::condition_variable cv;
+    std::thread worker;
+    bool stopping = false;
+    std::exception_ptr prefetch_error;  // first failure on the prefetch thread, rethrown to a caller
+    Stats stat;
+
+    // block size: about sqrt(n) elements, rounded up to whole pages
+    static int64_t compute_block_size(int64_t n) {
+        int64_t per_page = PAGE / static_cast<int64_t>(sizeof(T));
+        int64_t b = static_cast<int64_t>(std::sqrt(static_cast<double>(n)));
+        return std::max<int64_t>(1, (b + per_page - 1) / per_page) * per_page;
+    }
+
+    void read_block(int64_t b, T* data) {
+        char* dst = reinterpret_cast<char*>(data);
+        int64_t done = 0;
+        while (done < block_bytes) {
+            ssize_t got = pread(fd, dst + done, block_bytes - done, b * block_bytes + done);
+            if (got <= 0) throw std::runtime_error("ExternalSqrtDecomposition: read failed");
+            done += got;
+        }
+    }
+
+    void write_block(int64_t b, const T* data) {
+        const char* src = reinterpret_cast<const char*>(data);
+        int64_t done = 0;
+        while (done < block_bytes) {
+            ssize_t put = pwrite(fd, src + done, block_bytes - done, b * block_bytes + done);
+            if (put <= 0) throw std::runtime_error("ExternalSqrtDecomposition: write failed");
+            done += put;
+        }
+    }
+
+    // write `victim` and up to writeback_batch - 1 other old dirty frames, in file order
+    void write_back_batch(int victim) {
+        std::vector<int> batch{victim};
+        for (auto it = lru.rbegin(); it != lru.rend() && static_cast<int>(batch.size()) < writeback_batch; ++it) {
+            if (*it != victim && frames[*it].dirty) batch.push_back(*it);
+        }
+        std::sort(batch.begin(), batch.end(), [this](int a, int b) { return frames[a].block < frames[b].block; });
+        for (int f : batch) {
+            write_block(frames[f].block, frames[f].data);
+            frames[f].dirty = false;
+        }
+        stat.writebacks += batch.size();
+        ++stat.writeback_batches;
+    }
+
+    // a frame to load into, evicting the least recently used one if needed; caller holds mu
+    int acquire_frame() {
+        if (!free_frames.empty()) {
+            int f = free_frames.back();
+            free_frames.pop_back();
+            return f;
+        }
+        if (lru.empty()) throw std::runtime_error("ExternalSqrtDecomposition: cache too small");
+        int f = lru.back();
+        if (frames[f].dirty) write_back_batch(f);
+        lru.pop_back();
+        frame_of[frames[f].block] = -1;
+        frames[f].block = -1;
+        frames[f].ready = false;
+        return f;
+    }
+
+    void touch(int f) {
+        lru.splice(lru.begin(), lru, frames[f].pos);
+    }
+
+    // reserve frame f for block b, read it with mu released, then publish it; on a failed read
+    // the frame is given back and the error rethrown. Caller holds lock.
+    void load(int f, int64_t b, std::unique_lock<std::mutex>& lock) {
+        frames[f].block = b;
+        frames[f].ready = false;
+        frame_of[b] = f;
+        lock.unlock();
+        try {
+            read_block(b, frames[f].data);
+        } catch (...) {
+            lock.lock();
+            frames[f].block = -1;
+            frame_of[b] = -1;
+            free_frames.push_back(f);
+            cv.notify_all();
+            throw;
+        }
+        lock.lock();
+        install(f, b);
+        cv.notify_all();
+    }
+
+    void rethrow_prefetch_error() {
+        if (!prefetch_error) return;
+        std::exception_ptr e = prefetch_error;
+        prefetch_error = nullptr;
+        std::rethrow_exception(e);
+    }
+
+    // resident data of block b; caller holds lock for as long as it uses the pointer
+    T* get_block(int64_t b, std::unique_lock<std::mutex>& lock) {
+        rethrow_prefetch_error();
+        // a frame may be loaded and evicted again before we wake, so re-check
+        while (frame_of[b] != -1) {
+            int f = frame_of[b];
+            if (frames[f].ready) {
+                touch(f);
+                ++stat.hits;
+                return frames[f].data;
+            }
+            cv.wait(lock);
+        }
+        ++stat.misses;
+        int f = acquire_frame();
+        load(f, b, lock);
+        // the frame cannot be evicted while we hold mu: it is the most recently used
+        return frames[f].data;
+    }
+
+    void install(int f, int64_t b) {
+        frames[f].block = b;
+        frames[f].dirty = false;
+        frames[f].ready = true;
+        frame_of[b] = f;
+        lru.push_front(f);
+        frames[f].pos = lru.begin();
+    }
+
+    void request_prefetch(int64_t b) {
+        if (prefetch_distance == 0 || b < 0 || b >= num_block) return;
+        std::lock_guard<std::mutex> guard(mu);
+        if (frame_of[b] != -1 || queued[b]) return;
+        queued[b] = 1;
+        prefetch_queue.push_back(b);
+        cv.notify_all();
+    }
+
+    void prefetch_loop() {
+        std::unique_lock<std::mutex> lock(mu);
+        while (true) {
+            cv.wait(lock, [&] { return stopping || !prefetch_queue.empty(); });
+            if (stopping) return;
+            int64_t b = prefetch_queue.front();
+            prefetch_queue.pop_front();
+            queued[b] = 0;
+            // never evict for a prefetch when only one frame is left for the query path
+            if (frame_of[b] != -1 || (free_frames.empty() && lru.size() < 2)) continue;
+            // a failure here must not escape the thread: keep it for the next caller
+            try {
+                int f = acquire_frame();
+                load(f, b, lock);
+                ++stat.prefetched;
+            } catch (...) {
+                if (!prefetch_error) prefetch_error = std::current_exception();
+            }
+        }
+    }
+
+    void prefetch_around(int64_t lb, int64_t rb) {
+        for (int d = 1; d <= prefetch_distance; ++d) {
+            request_prefetch(lb - d);
+            request_prefetch(rb + d);
+        }
+    }
+
+    T scan(int64_t b, int64_t from, int64_t to) {
+        std::unique_lock<std::mutex> lock(mu);
+        const T* data = get_block(b, lock);
+        T res = T{};
+        for (int64_t i = from; i <= to; ++i) res += data[i - b * block_size];
+        DS_COUNT(partial_block_scans, 1);
+        DS_COUNT(partial_block_elems, to - from + 1);
+        return res;
+    }
+
+    // sizes the layout for n elements and allocates the frames; cache_bytes bounds the frames
+    void allocate(int64_t n, int64_t cache_bytes) {
+        if (n < 0) throw std::invalid_argument("ExternalSqrtDecomposition: size must be non-negative");
+        num_raw = n;
+        block_size = compute_block_size(n);
+        block_bytes = block_size * static_cast<int64_t>(sizeof(T));
+        num_block = (n + block_size - 1) / block_size;
+        blocks.assign(num_block, T{});
+        frame_of.assign(num_block, -1);
+        queued.assign(num_block, 0);
+
+        int64_t num_frames = std::max<int64_t>(2, std::min<int64_t>(num_block, cache_bytes / block_bytes));
+        frames.resize(num_frames);
+        for (int f = 0; f < num_frames; ++f) {
+            void* mem = nullptr;
+            if (posix_memalign(&mem, PAGE, block_bytes) != 0) throw std::bad_alloc();
+            frames[f].data = static_cast<T*>(mem);
+            free_frames.push_back(static_cast<int>(num_frames) - 1 - f);
+        }
+    }
+
+    void release() {
+        for (auto& fr : frames) free(fr.data);
+        frames.clear();
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+
+    void start_prefetch() {
+        if (prefetch_distance > 0) worker = std::thread(&ExternalSqrtDecomposition::prefetch_loop, this);
+    }
+
+public:
+    struct OpenExisting {};
+
+    // creates (or truncates) `path` holding n elements produced by init(i), default T{}.
+    // cache_bytes bounds the resident block frames (at least two frames are kept).
+    ExternalSqrtDecomposition(const std::string& path, int64_t n, int64_t cache_bytes,
+                              const std::function<T(int64_t)>& init = nullptr,
+                              int prefetch = 1, int batch = 16)
+        : prefetch_distance(prefetch), writeback_batch(std::max(1, batch)) {
+        try {
+            allocate(n, cache_bytes);
+            fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) throw std::runtime_error("ExternalSqrtDecomposition: cannot open " + path);
+            if (ftruncate(fd, num_block * block_bytes) != 0) throw std::runtime_error("ExternalSqrtDecomposition: cannot size " + path);
+
+            // stream the initial contents through one frame, computing block sums on the way
+            if (init) {
+                T* buf = frames[0].data;
+                for (int64_t b = 0; b < num_block; ++b) {
+                    std::fill(buf, buf + block_size, T{});
+                    for (int64_t i = b * block_size; i < std::min(n, (b + 1) * block_size); ++i) {
+                        buf[i - b * block_size] = init(i);
+                        blocks[b] += buf[i - b * block_size];
+                    }
+                    write_block(b, buf);
+                }
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+        start_prefetch();
+    }
+
+    // reopens a file written by an earlier instance with the same n and T; one pass over it
+    // rebuilds the block sums
+    ExternalSqrtDecomposition(OpenExisting, const std::string& path, int64_t n, int64_t cache_bytes,
+                              int prefetch = 1, int batch = 16)
+        : prefetch_distance(prefetch), writeback_batch(std::max(1, batch)) {
+        try {
+            allocate(n, cache_bytes);
+            fd = ::open(path.c_str(), O_RDWR);
+            if (fd < 0) throw std::runtime_error("ExternalSqrtDecomposition: cannot open " + path);
+            off_t end = lseek(fd, 0, SEEK_END);
+            if (end != static_cast<off_t>(num_block * block_bytes)) {
+                throw std::invalid_argument("ExternalSqrtDecomposition: " + path + " does not hold " + std::to_string(n) + " elements of this type");
+            }
+            T* buf = frames[0].data;
+            for (int64_t b = 0; b < num_block; ++b) {
+                read_block(b, buf);
+                for (int64_t i = b * block_size; i < std::min(n, (b + 1) * block_size); ++i) blocks[b] += buf[i - b * block_size];
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+        start_prefetch();
+    }
+
+    ExternalSqrtDecomposition(const ExternalSqrtDecomposition&) = delete;
+    ExternalSqrtDecomposition& operator=(const ExternalSqrtDecomposition&) = delete;
+
+    ~ExternalSqrtDecomposition() {
+        {
+            std::lock_guard<std::mutex> guard(mu);
+            stopping = true;
+        }
+        cv.notify_all();
+        if (worker.joinable()) worker.join();
+        try { flush(); } catch (...) {}
+        release();
+    }
+
+    // Return number of elements
+    int64_t size() const { return num_raw; }
+    int64_t block_length() const { return block_size; }
+    int64_t cache_frames() const { return static_cast<int64_t>(frames.size()); }
+    Stats stats() {
+        std::lock_guard<std::mutex> guard(mu);
+        return stat;
+    }
+
+    // write every dirty frame back, in file order; then rethrows a pending prefetch failure
+    void flush() {
+        std::lock_guard<std::mutex> guard(mu);
+        std::vector<int> dirty;
+        for (int f = 0; f < static_cast<int>(frames.size()); ++f) {
+            if (frames[f].block != -1 && frames[f].ready && frames[f].dirty) dirty.push_back(f);
+        }
+        std::sort(dirty.begin(), dirty.end(), [this](int a, int b) { return frames[a].block < frames[b].block; });
+        for (int f : dirty) {
+            write_block(frames[f].block, frames[f].data);
+            frames[f].dirty = false;
+        }
+        if (!dirty.empty()) {
+            stat.writebacks += dirty.size();
+            ++stat.writeback_batches;
+        }
+        rethrow_prefetch_error();
+    }
+
+    // point add: add delta at index idx (0-indexed)
+    void add(int64_t idx, T delta) {
+        if (idx < 0 || idx >= num_raw) throw std::out_of_range("ExternalSqrtDecomposition::add: index out of range");
+        int64_t b = idx / block_size;
+        std::unique_lock<std::mutex> lock(mu);
+        T* data = get_block(b, lock);
+        data[idx - b * block_size] += delta;
+        frames[frame_of[b]].dirty = true;
+        blocks[b] += delta;
+    }
+
+    // point set: assign new value to index idx (0-indexed)
+    void set(int64_t idx, T value) {
+        if (idx < 0 || idx >= num_raw) throw std::out_of_range("ExternalSqrtDecomposition::set: index out of range");
+        int64_t b = idx / block_size;
+        std::unique_lock<std::mutex> lock(mu);
+        T* data = get_block(b, lock);
+        T diff = value - data[idx - b * block_size];
+        data[idx - b * block_size] = value;
+        frames[frame_of[b]].dirty = true;
+        blocks[b] += diff;
+    }
+
+    // range sum query [l, r] inclusive (0-indexed)
+    T query(int64_t l, int64_t r) {
+        if (l < 0 || r < 0 || l >= num_raw || r >= num_raw || l > r) throw std::out_of_range("ExternalSqrtDecomposition::query: invalid range");
+        DS_LATENCY("ExternalSqrtDecomposition::query");
+        int64_t lb = l / block_size;
+        int64_t rb = r / block_size;
+        prefetch_around(lb, rb);
+        if (lb == rb) return scan(lb, l, r);
+        T res = scan(lb, l, (lb + 1) * block_size - 1);
+        for (int64_t b = lb + 1; b <= rb - 1; ++b) res += blocks[b];
+        DS_COUNT(full_block_scans, rb - lb - 1);
+        res += scan(rb, rb * block_size, r);
+        return res;
+    }
+};
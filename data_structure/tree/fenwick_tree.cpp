@@ -1,5 +1,6 @@
 #include <vector>
 #include <stdexcept>
+#include "../instrumentation.cpp"
 
 template <typename T>
 using vec = std::vector<T>;
@@ -9,7 +10,7 @@ class Fenwick {
 private:
     vec<T> self;
     int n = 0;
-    int lowbit(int x) {
+    int lowbit(int x) const {
         return x & -x;
     }
 
@@ -27,5 +28,33 @@ public:
         }
     }
 
-    
+    int size() const { return n; }
+
+    // point add: add delta at index idx (0-indexed)
+    void add(int idx, const T& delta) {
+        if (idx < 0 || idx >= n) throw std::out_of_range("Fenwick::add: index out of range");
+        DS_LATENCY("Fenwick::add");
+        for (int i = idx + 1; i <= n; i += lowbit(i)) {
+            self[i] += delta;
+            DS_COUNT(node_visits, 1);
+        }
+    }
+
+    // prefix sum [0, idx] inclusive, idx == -1 gives T{}
+    T prefix(int idx) const {
+        if (idx < -1 || idx >= n) throw std::out_of_range("Fenwick::prefix: index out of range");
+        DS_LATENCY("Fenwick::prefix");
+        T res = T{};
+        for (int i = idx + 1; i > 0; i -= lowbit(i)) {
+            res += self[i];
+            DS_COUNT(node_visits, 1);
+        }
+        return res;
+    }
+
+    // range sum query [l, r] inclusive (0-indexed)
+    T query(int l, int r) const {
+        if (l < 0 || r >= n || l > r) throw std::out_of_range("Fenwick::query: invalid range");
+        return prefix(r) - prefix(l - 1);
+    }
 };
\ No newline at end of file
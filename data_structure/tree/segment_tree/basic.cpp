@@ -1,6 +1,9 @@
 #include <vector>
 #include <functional>
 #include <stdexcept>
+#include <algorithm>
+#include "../../instrumentation.cpp"
+#include "../../../runtime/work_stealing.cpp"
 template<typename T>
 using vec = std::vector<T>;
 
@@ -22,29 +25,51 @@ private:
 public:
     SegmentTree() = default;
     // default: sum merge and identity T{}
+    // num_threads > 1 builds level by level on up to num_threads workers of the shared runtime
+    // (mergeFn must be safe to call concurrently)
     SegmentTree(const vec<T>& raw,
                 std::function<T(const T&, const T&)> mergeFn = [](const T& a, const T& b){ return a + b; },
-                T id = T{}) : n(static_cast<int>(raw.size())), identity(id), merge(mergeFn) {
+                T id = T{},
+                int num_threads = 1) : n(static_cast<int>(raw.size())), identity(id), merge(mergeFn) {
         base = next_power_of_two(n == 0 ? 1 : n);
         t.assign(base << 1, identity);
-        for (int i = 0; i < n; ++i) t[base + i] = raw[i];
-        for (int i = base - 1; i >= 1; --i) t[i] = merge(t[i << 1], t[i << 1 | 1]);
+        if (num_threads <= 1) {
+            for (int i = 0; i < n; ++i) t[base + i] = raw[i];
+            for (int i = base - 1; i >= 1; --i) t[i] = merge(t[i << 1], t[i << 1 | 1]);
+            return;
+        }
+        // levels narrower than one grain run inline on the caller
+        const int64_t min_grain = 4096;
+        ws::parallel_for(0, n, std::max<int64_t>(min_grain, n / num_threads), [&](int64_t b, int64_t e) {
+            for (int64_t i = b; i < e; ++i) t[base + i] = raw[i];
+        }, num_threads);
+        for (int lo = base >> 1; lo >= 1; lo >>= 1) {
+            ws::parallel_for(lo, lo << 1, std::max<int64_t>(min_grain, lo / num_threads), [&](int64_t b, int64_t e) {
+                for (int64_t i = b; i < e; ++i) t[i] = merge(t[i << 1], t[i << 1 | 1]);
+            }, num_threads);
+        }
     }
 
     // set value at index (0-based)
     void set(int idx, const T& value) {
         if (idx < 0 || idx >= n) throw std::out_of_range("index out of range");
+        DS_LATENCY("SegmentTree::set");
         int i = base + idx;
         t[i] = value;
         for (i >>= 1; i >= 1; i >>= 1) t[i] = merge(t[i << 1], t[i << 1 | 1]);
+        DS_COUNT(node_visits, 2 * (31 - __builtin_clz(base)) + 1);
+        DS_COUNT(merge_calls, 31 - __builtin_clz(base));
     }
 
     // apply function to a single element
     void update(int idx, const std::function<T(const T&)>& f) {
         if (idx < 0 || idx >= n) throw std::out_of_range("index out of range");
+        DS_LATENCY("SegmentTree::update");
         int i = base + idx;
         t[i] = f(t[i]);
         for (i >>= 1; i >= 1; i >>= 1) t[i] = merge(t[i << 1], t[i << 1 | 1]);
+        DS_COUNT(node_visits, 2 * (31 - __builtin_clz(base)) + 1);
+        DS_COUNT(merge_calls, 31 - __builtin_clz(base));
     }
 
     // add (convenience) -- uses operator+
@@ -60,6 +85,7 @@ public:
 
     // query [l, r] inclusive
     T query(int l, int r) const {
+        DS_LATENCY("SegmentTree::query");
         if (l > r) return identity;
         if (l < 0) l = 0;
         if (r >= n) r = n - 1;
@@ -67,10 +93,11 @@ public:
         int R = r + base;
         T resl = identity, resr = identity;
         while (L <= R) {
-            if (L & 1) resl = merge(resl, t[L++]);
-            if (!(R & 1)) resr = merge(t[R--], resr);
+            if (L & 1) { resl = merge(resl, t[L++]); DS_COUNT(node_visits, 1); DS_COUNT(merge_calls, 1); }
+            if (!(R & 1)) { resr = merge(t[R--], resr); DS_COUNT(node_visits, 1); DS_COUNT(merge_calls, 1); }
             L >>= 1; R >>= 1;
         }
+        DS_COUNT(merge_calls, 1);
         return merge(resl, resr);
     }
 };
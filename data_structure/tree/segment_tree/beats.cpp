@@ -0,0 +1,248 @@
+#include <vector>
+#include <limits>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include "../../instrumentation.cpp"
+template<typename T>
+using vec = std::vector<T>;
+
+// SegmentTreeBeats: range chmin / chmax / add with range sum, min and max queries,
+// amortized O(log^2 n) per operation (Ji's segment tree beats).
+//
+// Every node keeps the largest value, the strictly second largest and how often the largest
+// occurs (and the same for the minimum). A chmin(x) with second_max < x < max only lowers the
+// max entries, so it is applied to the node as a tag; otherwise it recurses.
+// Nodes are stored as separate arrays (structure of arrays) in the 2n - 1 node pre-order layout:
+// the left child of v is v + 1, the right child is v + 2 * (left length).
+// T holds values, S holds sums (keep it wide enough for n * max |value|); values must stay
+// strictly between numeric_limits<T>::lowest() and max(), which mark a missing second max / min.
+template <typename T, typename S = long long>
+class SegmentTreeBeats {
+private:
+    static constexpr T NONE_LOW = std::numeric_limits<T>::lowest();   // "no second max"
+    static constexpr T NONE_HIGH = std::numeric_limits<T>::max();     // "no second min"
+
+    int n = 0;
+    vec<T> max1, max2, min1, min2, lazy;
+    vec<int> max_cnt, min_cnt;
+    vec<S> sum;
+
+    static int right_child(int v, int l, int mid) { return v + 2 * (mid - l + 1); }
+
+    void pull(int v, int a, int b) {
+        sum[v] = sum[a] + sum[b];
+        if (max1[a] == max1[b]) {
+            max1[v] = max1[a];
+            max2[v] = std::max(max2[a], max2[b]);
+            max_cnt[v] = max_cnt[a] + max_cnt[b];
+        } else if (max1[a] > max1[b]) {
+            max1[v] = max1[a];
+            max2[v] = std::max(max2[a], max1[b]);
+            max_cnt[v] = max_cnt[a];
+        } else {
+            max1[v] = max1[b];
+            max2[v] = std::max(max1[a], max2[b]);
+            max_cnt[v] = max_cnt[b];
+        }
+        if (min1[a] == min1[b]) {
+            min1[v] = min1[a];
+            min2[v] = std::min(min2[a], min2[b]);
+            min_cnt[v] = min_cnt[a] + min_cnt[b];
+        } else if (min1[a] < min1[b]) {
+            min1[v] = min1[a];
+            min2[v] = std::min(min2[a], min1[b]);
+            min_cnt[v] = min_cnt[a];
+        } else {
+            min1[v] = min1[b];
+            min2[v] = std::min(min1[a], min2[b]);
+            min_cnt[v] = min_cnt[b];
+        }
+    }
+
+    void apply_add(int v, int len, T x) {
+        sum[v] += static_cast<S>(x) * len;
+        max1[v] += x;
+        min1[v] += x;
+        if (max2[v] != NONE_LOW) max2[v] += x;
+        if (min2[v] != NONE_HIGH) min2[v] += x;
+        lazy[v] += x;
+    }
+
+    // requires max2 < x < max1
+    void apply_chmin(int v, T x) {
+        sum[v] -= static_cast<S>(max1[v] - x) * max_cnt[v];
+        if (min1[v] == max1[v]) min1[v] = x;
+        else if (min2[v] == max1[v]) min2[v] = x;
+        max1[v] = x;
+    }
+
+    // requires min1 < x < min2
+    void apply_chmax(int v, T x) {
+        sum[v] += static_cast<S>(x - min1[v]) * min_cnt[v];
+        if (max1[v] == min1[v]) max1[v] = x;
+        else if (max2[v] == min1[v]) max2[v] = x;
+        min1[v] = x;
+    }
+
+    void push(int v, int l, int r) {
+        int mid = (l + r) / 2;
+        int a = v + 1, b = right_child(v, l, mid);
+        if (lazy[v] != T{}) {
+            apply_add(a, mid - l + 1, lazy[v]);
+            apply_add(b, r - mid, lazy[v]);
+            lazy[v] = T{};
+        }
+        for (int c : {a, b}) {
+            if (max1[c] > max1[v]) apply_chmin(c, max1[v]);
+            if (min1[c] < min1[v]) apply_chmax(c, min1[v]);
+        }
+    }
+
+    void build(const vec<T>& raw, int v, int l, int r) {
+        if (l == r) {
+            max1[v] = min1[v] = raw[l];
+            max2[v] = NONE_LOW;
+            min2[v] = NONE_HIGH;
+            max_cnt[v] = min_cnt[v] = 1;
+            sum[v] = raw[l];
+            return;
+        }
+        int mid = (l + r) / 2;
+        int a = v + 1, b = right_child(v, l, mid);
+        build(raw, a, l, mid);
+        build(raw, b, mid + 1, r);
+        pull(v, a, b);
+    }
+
+    void chmin(int ql, int qr, T x, int v, int l, int r) {
+        DS_COUNT(node_visits, 1);
+        if (qr < l || r < ql || max1[v] <= x) return;
+        if (ql <= l && r <= qr && max2[v] < x) {
+            apply_chmin(v, x);
+            return;
+        }
+        push(v, l, r);
+        int mid = (l + r) / 2;
+        int a = v + 1, b = right_child(v, l, mid);
+        chmin(ql, qr, x, a, l, mid);
+        chmin(ql, qr, x, b, mid + 1, r);
+        pull(v, a, b);
+    }
+
+    void chmax(int ql, int qr, T x, int v, int l, int r) {
+        DS_COUNT(node_visits, 1);
+        if (qr < l || r < ql || min1[v] >= x) return;
+        if (ql <= l && r <= qr && min2[v] > x) {
+            apply_chmax(v, x);
+            return;
+        }
+        push(v, l, r);
+        int mid = (l + r) / 2;
+        int a = v + 1, b = right_child(v, l, mid);
+        chmax(ql, qr, x, a, l, mid);
+        chmax(ql, qr, x, b, mid + 1, r);
+        pull(v, a, b);
+    }
+
+    void add(int ql, int qr, T x, int v, int l, int r) {
+        DS_COUNT(node_visits, 1);
+        if (qr < l || r < ql) return;
+        if (ql <= l && r <= qr) {
+            apply_add(v, r - l + 1, x);
+            return;
+        }
+        push(v, l, r);
+        int mid = (l + r) / 2;
+        int a = v + 1, b = right_child(v, l, mid);
+        add(ql, qr, x, a, l, mid);
+        add(ql, qr, x, b, mid + 1, r);
+        pull(v, a, b);
+    }
+
+    // fold every node fully inside [ql, qr] with f(v)
+    template <typename F>
+    void visit(int ql, int qr, int v, int l, int r, F& f) {
+        DS_COUNT(node_visits, 1);
+        if (qr < l || r < ql) return;
+        if (ql <= l && r <= qr) {
+            f(v);
+            return;
+        }
+        push(v, l, r);
+        int mid = (l + r) / 2;
+        visit(ql, qr, v + 1, l, mid, f);
+        visit(ql, qr, right_child(v, l, mid), mid + 1, r, f);
+    }
+
+    void check_range(int l, int r, const char* what) const {
+        if (l < 0 || r >= n || l > r) throw std::out_of_range(std::string("SegmentTreeBeats::") + what + ": invalid range");
+    }
+
+public:
+    SegmentTreeBeats() = default;
+    explicit SegmentTreeBeats(const vec<T>& raw) : n(static_cast<int>(raw.size())) {
+        size_t nodes = n == 0 ? 0 : 2 * static_cast<size_t>(n) - 1;
+        max1.assign(nodes, T{}); max2.assign(nodes, T{});
+        min1.assign(nodes, T{}); min2.assign(nodes, T{});
+        lazy.assign(nodes, T{});
+        max_cnt.assign(nodes, 0); min_cnt.assign(nodes, 0);
+        sum.assign(nodes, S{});
+        if (n > 0) build(raw, 0, 0, n - 1);
+    }
+
+    int size() const { return n; }
+
+    size_t memory_bytes() const {
+        return max1.size() * (5 * sizeof(T) + 2 * sizeof(int) + sizeof(S));
+    }
+
+    // a[i] = min(a[i], x) for i in [l, r]
+    void chmin(int l, int r, T x) {
+        check_range(l, r, "chmin");
+        chmin(l, r, x, 0, 0, n - 1);
+    }
+
+    // a[i] = max(a[i], x) for i in [l, r]
+    void chmax(int l, int r, T x) {
+        check_range(l, r, "chmax");
+        chmax(l, r, x, 0, 0, n - 1);
+    }
+
+    // a[i] += x for i in [l, r]
+    void add(int l, int r, T x) {
+        check_range(l, r, "add");
+        add(l, r, x, 0, 0, n - 1);
+    }
+
+    // query [l, r] inclusive
+    S query_sum(int l, int r) {
+        check_range(l, r, "query_sum");
+        S res = S{};
+        auto f = [&](int v) { res += sum[v]; };
+        visit(l, r, 0, 0, n - 1, f);
+        return res;
+    }
+
+    T query_max(int l, int r) {
+        check_range(l, r, "query_max");
+        T res = NONE_LOW;
+        auto f = [&](int v) { res = std::max(res, max1[v]); };
+        visit(l, r, 0, 0, n - 1, f);
+        return res;
+    }
+
+    T query_min(int l, int r) {
+        check_range(l, r, "query_min");
+        T res = NONE_HIGH;
+        auto f = [&](int v) { res = std::min(res, min1[v]); };
+        visit(l, r, 0, 0, n - 1, f);
+        return res;
+    }
+
+    T get(int idx) {
+        check_range(idx, idx, "get");
+        return query_max(idx, idx);
+    }
+};
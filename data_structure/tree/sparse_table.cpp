@@ -0,0 +1,134 @@
+#include <vector>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+#include <cstddef>
+#include "../../runtime/work_stealing.cpp"
+
+// run f(begin, end) over [0, count) split into num_threads contiguous chunks, on at most
+// num_threads workers of the shared runtime
+template <typename F>
+void parallel_chunks(int count, int num_threads, F f) {
+    if (num_threads <= 1 || count < 2) {
+        f(0, count);
+        return;
+    }
+    int chunk = (count + num_threads - 1) / num_threads;
+    ws::parallel_for(0, count, chunk, [&](int64_t begin, int64_t end) { f(static_cast<int>(begin), static_cast<int>(end)); }, num_threads);
+}
+
+// SparseTable: static range query in O(1) for idempotent merges (min, max, gcd, and, or).
+// levels are stored level-major in one flat array, level k holds n - 2^k + 1 entries.
+template <typename T>
+class SparseTable {
+private:
+    std::vector<T> t;
+    std::vector<size_t> offset;   // start of level k inside t
+    int n = 0;
+    int levels = 0;
+    std::function<T(const T&, const T&)> merge;
+
+    static int floor_log2(unsigned x) {
+        return 31 - __builtin_clz(x);
+    }
+
+public:
+    SparseTable() = default;
+    // default: min merge
+    SparseTable(const std::vector<T>& raw,
+                std::function<T(const T&, const T&)> mergeFn = [](const T& a, const T& b){ return b < a ? b : a; },
+                int num_threads = 1) : n(static_cast<int>(raw.size())), merge(mergeFn) {
+        levels = n == 0 ? 0 : floor_log2(n) + 1;
+        offset.assign(levels + 1, 0);
+        for (int k = 0; k < levels; ++k) offset[k + 1] = offset[k] + (n - (1 << k) + 1);
+        t.resize(offset[levels]);
+        std::copy(raw.begin(), raw.end(), t.begin());
+        for (int k = 1; k < levels; ++k) {
+            const T* prev = t.data() + offset[k - 1];
+            T* cur = t.data() + offset[k];
+            int half = 1 << (k - 1);
+            int count = n - (1 << k) + 1;
+            parallel_chunks(count, num_threads, [&](int begin, int end) {
+                for (int i = begin; i < end; ++i) cur[i] = merge(prev[i], prev[i + half]);
+            });
+        }
+    }
+
+    int size() const { return n; }
+
+    // bytes held by the table itself
+    size_t memory_bytes() const {
+        return t.size() * sizeof(T) + offset.size() * sizeof(size_t);
+    }
+
+    // query [l, r] inclusive
+    T query(int l, int r) const {
+        if (l < 0 || r >= n || l > r) throw std::out_of_range("SparseTable::query: invalid range");
+        int k = floor_log2(static_cast<unsigned>(r - l + 1));
+        const T* level = t.data() + offset[k];
+        return merge(level[l], level[r - (1 << k) + 1]);
+    }
+};
+
+// DisjointSparseTable: static range query in O(1) for any associative merge (sum, product, matrix...).
+// leaves are padded to a power of two; level h stores, for every block of size 2^(h+1),
+// suffix aggregates of its left half and prefix aggregates of its right half.
+// level 0 degenerates to the raw array, so single-element queries read it directly.
+template <typename T>
+class DisjointSparseTable {
+private:
+    std::vector<T> t;   // level-major, each level has `base` entries
+    int n = 0;
+    int base = 1;
+    int levels = 1;
+    T identity;
+    std::function<T(const T&, const T&)> merge;
+
+    static int floor_log2(unsigned x) {
+        return 31 - __builtin_clz(x);
+    }
+
+public:
+    DisjointSparseTable() = default;
+    // default: sum merge and identity T{}
+    DisjointSparseTable(const std::vector<T>& raw,
+                        std::function<T(const T&, const T&)> mergeFn = [](const T& a, const T& b){ return a + b; },
+                        T id = T{},
+                        int num_threads = 1) : n(static_cast<int>(raw.size())), identity(id), merge(mergeFn) {
+        while (base < n) base <<= 1;
+        levels = base > 1 ? floor_log2(base) : 1;
+        t.assign(static_cast<size_t>(levels) * base, identity);
+        std::copy(raw.begin(), raw.end(), t.begin());
+        for (int h = 1; h < levels; ++h) {
+            T* cur = t.data() + static_cast<size_t>(h) * base;
+            const T* a = t.data();
+            int half = 1 << h;
+            int num_blocks = base / (half << 1);
+            parallel_chunks(num_blocks, num_threads, [&](int begin, int end) {
+                for (int b = begin; b < end; ++b) {
+                    int mid = b * (half << 1) + half;
+                    cur[mid - 1] = a[mid - 1];
+                    for (int i = mid - 2; i >= mid - half; --i) cur[i] = merge(a[i], cur[i + 1]);
+                    cur[mid] = a[mid];
+                    for (int i = mid + 1; i < mid + half; ++i) cur[i] = merge(cur[i - 1], a[i]);
+                }
+            });
+        }
+    }
+
+    int size() const { return n; }
+
+    size_t memory_bytes() const {
+        return t.size() * sizeof(T);
+    }
+
+    // query [l, r] inclusive
+    T query(int l, int r) const {
+        if (l < 0 || r >= n || l > r) throw std::out_of_range("DisjointSparseTable::query: invalid range");
+        if (l == r) return t[l];
+        int h = floor_log2(static_cast<unsigned>(l ^ r));
+        // h == 0: l, r are neighbours inside a 2-block and level 0 is the raw array
+        const T* level = t.data() + static_cast<size_t>(h) * base;
+        return merge(level[l], level[r]);
+    }
+};
@@ -2,6 +2,7 @@
 #include <cmath>
 #include <stdexcept>
 #include <algorithm>
+#include "../instrumentation.cpp"
 
 template <typename T>
 using vec = std::vector<T>;
@@ -73,17 +74,23 @@ public:
     // range sum query [l, r] inclusive (0-indexed)
     T query(int l, int r) const {
         if (l < 0 || r < 0 || l >= num_raw || r >= num_raw || l > r) throw std::out_of_range("SqrtDecomposition::query: invalid range");
+        DS_LATENCY("SqrtDecomposition::query");
         T res = T{};
         int lb = l / block_size;
         int rb = r / block_size;
         if (lb == rb) {
             for (int i = l; i <= r; ++i) res += raw[i];
+            DS_COUNT(partial_block_scans, 1);
+            DS_COUNT(partial_block_elems, r - l + 1);
             return res;
         }
         int endLb = (lb + 1) * block_size - 1;
         for (int i = l; i <= std::min(endLb, num_raw - 1); ++i) res += raw[i];
         for (int b = lb + 1; b <= rb - 1; ++b) res += blocks[b];
         for (int i = rb * block_size; i <= r; ++i) res += raw[i];
+        DS_COUNT(partial_block_scans, 2);
+        DS_COUNT(partial_block_elems, (std::min(endLb, num_raw - 1) - l + 1) + (r - rb * block_size + 1));
+        DS_COUNT(full_block_scans, rb - lb - 1);
         return res;
     }
     
@@ -0,0 +1,97 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include "sqrt_decomposition.cpp"
+#include "external_sqrt_decomposition.cpp"
+
+int main() {
+    using namespace std;
+    const string path = "test_external_sqrt_decomposition.bin";
+
+    // Test 1: same answers as the in-memory structure under a cache of two frames
+    {
+        const int n = 100000;
+        vec<long long> a(n);
+        for (int i = 0; i < n; ++i) a[i] = i % 97;
+        SqrtDecomposition<long long> ref(a);
+        ExternalSqrtDecomposition<long long> ext(path, n, 0, [](int64_t i){ return (long long)(i % 97); });
+        assert(ext.cache_frames() == 2);
+        assert(ext.block_length() % 512 == 0);   // whole pages of 8-byte elements
+
+        std::mt19937 rng(12345);
+        for (int it = 0; it < 20000; ++it) {
+            int o = rng() % 3;
+            int i = rng() % n;
+            if (o == 0) {
+                long long d = static_cast<long long>(rng() % 2001) - 1000;
+                ref.add(i, d);
+                ext.add(i, d);
+            } else if (o == 1) {
+                long long v = static_cast<long long>(rng() % 2001) - 1000;
+                ref.set(i, v);
+                ext.set(i, v);
+            } else {
+                int j = rng() % n;
+                if (i > j) swap(i, j);
+                assert(ext.query(i, j) == ref.query(i, j));
+            }
+        }
+        auto st = ext.stats();
+        assert(st.misses > 0);
+        assert(st.writebacks > 0);
+
+        bool threw = false;
+        try { ext.query(5, 4); } catch(...) { threw = true; }
+        assert(threw);
+    }
+
+    // Test 2: a larger cache with prefetch keeps sequential scans mostly resident
+    {
+        const int n = 1 << 18;
+        ExternalSqrtDecomposition<int> ext(path, n, 1 << 20, [](int64_t){ return 1; }, 2);
+        int step = static_cast<int>(ext.block_length());
+        for (int l = 0; l + step < n; l += step) assert(ext.query(l, l + step / 2) == step / 2 + 1);
+        ext.set(7, 10);
+        ext.flush();
+        assert(ext.query(0, n - 1) == n + 9);
+    }
+
+    // Test 3: the file outlives the structure and reopens with the same contents
+    {
+        const int n = 1 << 18;
+        using Ext = ExternalSqrtDecomposition<int>;
+        Ext ext(Ext::OpenExisting{}, path, n, 1 << 16);
+        assert(ext.query(0, n - 1) == n + 9);
+        assert(ext.query(7, 7) == 10);
+        ext.add(n - 1, 5);
+    }
+    {
+        using Ext = ExternalSqrtDecomposition<int>;
+        Ext ext(Ext::OpenExisting{}, path, 1 << 18, 1 << 16, 0);
+        assert(ext.query(0, (1 << 18) - 1) == (1 << 18) + 14);
+        bool threw = false;
+        try { Ext wrong(Ext::OpenExisting{}, path, 1 << 20, 1 << 16); } catch (const invalid_argument&) { threw = true; }
+        assert(threw);
+    }
+
+    // Test 4: failed reads, on the query path or the prefetch thread, reach the caller
+    {
+        const int n = 1 << 18;
+        using Ext = ExternalSqrtDecomposition<int>;
+        Ext ext(Ext::OpenExisting{}, path, n, 0, 2);
+        assert(truncate(path.c_str(), 0) == 0);
+        int failures = 0;
+        for (int l = 0; l < n; l += static_cast<int>(ext.block_length())) {
+            try { ext.query(l, l); } catch (const runtime_error&) { ++failures; }
+        }
+        assert(failures > 0);
+        assert(ext.stats().prefetched == 0);
+    }
+
+    std::remove(path.c_str());
+    cout << "ExternalSqrtDecomposition tests passed" << endl;
+    return 0;
+}
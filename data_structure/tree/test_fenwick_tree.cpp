@@ -0,0 +1,24 @@
+#include <iostream>
+#include <cassert>
+#include "fenwick_tree.cpp"
+
+int main() {
+    using namespace std;
+    vec<int> a = {1,2,3,4,5};
+    Fenwick<int> fw(a);
+    assert(fw.prefix(-1) == 0);
+    assert(fw.prefix(0) == 1);
+    assert(fw.prefix(4) == 15);
+    assert(fw.query(1,3) == 2+3+4);
+
+    fw.add(2, 7); // a[2] = 10
+    assert(fw.query(2,2) == 10);
+    assert(fw.query(0,4) == 1+2+10+4+5);
+
+    bool threw = false;
+    try { fw.add(5, 1); } catch(...) { threw = true; }
+    assert(threw);
+
+    cout << "Fenwick tests passed" << endl;
+    return 0;
+}
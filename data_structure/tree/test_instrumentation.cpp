@@ -0,0 +1,64 @@
+#define DS_INSTRUMENT_LATENCY
+#include <iostream>
+#include <sstream>
+#include <cassert>
+#include "segment_tree/basic.cpp"
+#include "sqrt_decomposition.cpp"
+#include "fenwick_tree.cpp"
+
+int main() {
+    using namespace std;
+    using ds_instrument::counters;
+    vec<int> a(16, 1);
+
+    // SegmentTree over 16 leaves: a point set walks 4 levels
+    SegmentTree<int> seg(a);
+    ds_instrument::reset();
+    seg.set(3, 5);
+    assert(counters.merge_calls == 4);
+    assert(counters.node_visits == 9);
+    ds_instrument::reset();
+    assert(seg.query(0,15) == 20);
+    assert(counters.node_visits == 1);   // root only
+
+    // SqrtDecomposition with block size 4: [1, 14] = partial, 2 full, partial
+    SqrtDecomposition<int> sq(a);
+    ds_instrument::reset();
+    assert(sq.query(1,14) == 14);
+    assert(counters.partial_block_scans == 2);
+    assert(counters.partial_block_elems == 6);
+    assert(counters.full_block_scans == 2);
+
+    // Fenwick: prefix(14) = 15 = 0b1111 touches 4 nodes
+    Fenwick<int> fw(a);
+    ds_instrument::reset();
+    assert(fw.prefix(14) == 15);
+    assert(counters.node_visits == 4);
+
+    ostringstream os;
+    ds_instrument::dump_json(os);
+    assert(os.str().find("\"node_visits\":4") != string::npos);
+    assert(os.str().find("\"Fenwick::prefix\":{\"count\":1") != string::npos);
+
+    // reset() clears histograms in place: the references cached by DS_LATENCY stay valid
+    ds_instrument::reset();
+    seg.set(1, 2);
+    seg.set(2, 2);
+    assert(ds_instrument::histogram("SegmentTree::set").count == 2);
+    ds_instrument::reset();
+    assert(ds_instrument::histogram("SegmentTree::set").count == 0);
+    seg.set(1, 3);
+    assert(ds_instrument::histogram("SegmentTree::set").count == 1);
+    assert(counters.merge_calls == 4);
+
+    // rejected calls are not timed
+    try { seg.set(16, 0); assert(false); } catch (const out_of_range&) {}
+    try { sq.query(0, 16); assert(false); } catch (const out_of_range&) {}
+    try { fw.add(-1, 1); assert(false); } catch (const out_of_range&) {}
+    assert(ds_instrument::histogram("SegmentTree::set").count == 1);
+    assert(ds_instrument::histogram("SqrtDecomposition::query").count == 0);
+    assert(ds_instrument::histogram("Fenwick::add").count == 0);
+
+    cout << "Instrumentation tests passed" << endl;
+    return 0;
+}
@@ -19,6 +19,16 @@ int main(){
     assert(seg.get(2) == 15);
     assert(seg.query(0,4) == 1+2+15+4+5);
 
+    // parallel build on the shared runtime matches the serial one
+    ws::set_num_threads(4);
+    vec<int> big(100000);
+    for (int i = 0; i < (int)big.size(); ++i) big[i] = (i * 7919) % 1000;
+    auto mx = [](const int &x, const int &y){ return x > y ? x : y; };
+    SegmentTree<int> serial(big, mx, 0), parallel(big, mx, 0, 4);
+    for (int l = 0; l < (int)big.size(); l += 997) {
+        assert(serial.query(l, (int)big.size() - 1 - l / 2) == parallel.query(l, (int)big.size() - 1 - l / 2));
+    }
+
     cout << "SegmentTree basic tests passed" << endl;
     return 0;
 }
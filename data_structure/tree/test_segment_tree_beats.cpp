@@ -0,0 +1,70 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <algorithm>
+#include "segment_tree/beats.cpp"
+
+int main() {
+    using namespace std;
+    // small hand-checked case
+    SegmentTreeBeats<long long> st(vec<long long>{5, 1, 4, 2, 3});
+    assert(st.query_sum(0, 4) == 15);
+    st.chmin(0, 4, 3);                      // 3 1 3 2 3
+    assert(st.query_sum(0, 4) == 12 && st.query_max(0, 4) == 3);
+    st.chmax(1, 3, 2);                      // 3 2 3 2 3
+    assert(st.query_min(0, 4) == 2 && st.query_sum(1, 3) == 7);
+    st.add(0, 2, -5);                       // -2 -3 -2 2 3
+    assert(st.query_min(0, 4) == -3 && st.get(3) == 2 && st.query_sum(0, 4) == -2);
+    bool threw = false;
+    try { st.chmin(3, 2, 0); } catch (const out_of_range&) { threw = true; }
+    assert(threw);
+
+    // differential test against a plain array, small values so max/min ties are common
+    mt19937 rng(2024);
+    for (int n : {1, 2, 3, 7, 64, 100, 1000}) {
+        vec<long long> ref(n);
+        for (auto &x : ref) x = static_cast<long long>(rng() % 21) - 10;
+        SegmentTreeBeats<long long> beats(ref);
+        for (int it = 0; it < 20000; ++it) {
+            int l = rng() % n, r = rng() % n;
+            if (l > r) swap(l, r);
+            long long x = static_cast<long long>(rng() % 31) - 15;
+            switch (rng() % 6) {
+            case 0:
+                beats.chmin(l, r, x);
+                for (int i = l; i <= r; ++i) ref[i] = min(ref[i], x);
+                break;
+            case 1:
+                beats.chmax(l, r, x);
+                for (int i = l; i <= r; ++i) ref[i] = max(ref[i], x);
+                break;
+            case 2:
+                beats.add(l, r, x);
+                for (int i = l; i <= r; ++i) ref[i] += x;
+                break;
+            case 3: {
+                long long s = 0;
+                for (int i = l; i <= r; ++i) s += ref[i];
+                assert(beats.query_sum(l, r) == s);
+                break;
+            }
+            case 4:
+                assert(beats.query_max(l, r) == *max_element(ref.begin() + l, ref.begin() + r + 1));
+                break;
+            default:
+                assert(beats.query_min(l, r) == *min_element(ref.begin() + l, ref.begin() + r + 1));
+                break;
+            }
+        }
+        for (int i = 0; i < n; ++i) assert(beats.get(i) == ref[i]);
+    }
+
+    // int values with a wide sum type
+    SegmentTreeBeats<int, long long> wide(vec<int>(100000, 2000000000));
+    assert(wide.query_sum(0, 99999) == 200000000000000LL);
+    wide.chmin(0, 49999, 0);
+    assert(wide.query_sum(0, 99999) == 100000000000000LL);
+
+    cout << "SegmentTreeBeats tests passed" << endl;
+    return 0;
+}
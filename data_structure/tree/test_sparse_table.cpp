@@ -0,0 +1,52 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <algorithm>
+#include "sparse_table.cpp"
+
+int main() {
+    using namespace std;
+    // Test 1: fixed array, min/max
+    vector<int> a = {5,1,3,2,4};
+    SparseTable<int> mn(a);
+    assert(mn.query(0,4) == 1);
+    assert(mn.query(2,4) == 2);
+    assert(mn.query(3,3) == 2);
+    SparseTable<int> mx(a, [](const int &x, const int &y){ return x > y ? x : y; });
+    assert(mx.query(0,4) == 5);
+    assert(mx.query(1,3) == 3);
+
+    bool threw = false;
+    try { mn.query(3,2); } catch(...) { threw = true; }
+    assert(threw);
+
+    // Test 2: disjoint sparse table with sum and product
+    DisjointSparseTable<long long> sum(vector<long long>{1,2,3,4,5});
+    assert(sum.query(0,4) == 15);
+    assert(sum.query(1,3) == 2+3+4);
+    assert(sum.query(2,2) == 3);
+    DisjointSparseTable<long long> prod(vector<long long>{1,2,3,4,5}, [](const long long &x, const long long &y){ return x * y; }, 1);
+    assert(prod.query(1,4) == 120);
+
+    // Test 3: randomized against brute force, sequential and parallel builds
+    std::mt19937 rng(12345);
+    for (int n : {1, 2, 3, 17, 64, 1000}) {
+        vector<int> b(n);
+        for (auto &x : b) x = static_cast<int>(rng() % 2001) - 1000;
+        for (int threads : {1, 4}) {
+            SparseTable<int> st(b, [](const int &x, const int &y){ return x < y ? x : y; }, threads);
+            DisjointSparseTable<int> dst(b, [](const int &x, const int &y){ return x + y; }, 0, threads);
+            for (int q = 0; q < 2000; ++q) {
+                int l = rng() % n, r = rng() % n;
+                if (l > r) swap(l, r);
+                int minv = b[l], sumv = 0;
+                for (int i = l; i <= r; ++i) { minv = min(minv, b[i]); sumv += b[i]; }
+                assert(st.query(l, r) == minv);
+                assert(dst.query(l, r) == sumv);
+            }
+        }
+    }
+
+    cout << "SparseTable tests passed" << endl;
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <algorithm>
+#include "wavelet_matrix.cpp"
+
+int main() {
+    using namespace std;
+    // Test 1: fixed array
+    vector<int> a = {5,1,3,2,4,1,0};
+    WaveletMatrix<int> wm(a);
+    for (int i = 0; i < 7; ++i) assert(wm.access(i) == a[i]);
+    assert(wm.kth_smallest(0,6,0) == 0);
+    assert(wm.kth_smallest(0,4,2) == 3);
+    assert(wm.rank(1, 7) == 2);
+    assert(wm.rank(1, 2) == 1);
+    assert(wm.select(1, 1) == 5);
+    assert(wm.select(9, 0) == -1);
+    assert(wm.range_freq(0,6,1,4) == 4);   // 1,3,2,1
+
+    bool threw = false;
+    try { wm.kth_smallest(0,2,3); } catch(...) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { WaveletMatrix<int> bad(vector<int>{1,-1}); } catch(...) { threw = true; }
+    assert(threw);
+
+    // Test 2: randomized against brute force, sequential and parallel builds
+    std::mt19937 rng(12345);
+    for (int n : {1, 63, 64, 65, 1000, 5000}) {
+        vector<int> b(n);
+        for (auto &x : b) x = static_cast<int>(rng() % 300);
+        for (int threads : {1, 4}) {
+            WaveletMatrix<int> w(b, threads);
+            for (int q = 0; q < 500; ++q) {
+                int l = rng() % n, r = rng() % n;
+                if (l > r) swap(l, r);
+                vector<int> s(b.begin() + l, b.begin() + r + 1);
+                sort(s.begin(), s.end());
+                int k = rng() % (r - l + 1);
+                assert(w.kth_smallest(l, r, k) == s[k]);
+
+                int lo = rng() % 310, hi = rng() % 310;
+                assert(w.range_freq(l, r, lo, hi) ==
+                       (lo < hi ? int(lower_bound(s.begin(), s.end(), hi) - lower_bound(s.begin(), s.end(), lo)) : 0));
+
+                int v = b[rng() % n];
+                int cnt = static_cast<int>(count(b.begin(), b.begin() + r, v));
+                assert(w.rank(v, r) == cnt);
+                if (cnt > 0) {
+                    int kk = rng() % cnt, seen = -1, pos = -1;
+                    for (int i = 0; i < n && seen < kk; ++i) if (b[i] == v) { ++seen; pos = i; }
+                    assert(w.select(v, kk) == pos);
+                }
+            }
+        }
+    }
+
+    cout << "WaveletMatrix tests passed" << endl;
+    return 0;
+}
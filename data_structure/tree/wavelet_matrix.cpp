@@ -0,0 +1,265 @@
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include "sparse_table.cpp"
+
+// BitVector: static bit array with O(1) rank and O(log n) select.
+// rank directory keeps one cumulative count per 256-bit superblock (12.5% overhead).
+class BitVector {
+private:
+    static constexpr int WORDS_PER_BLOCK = 4;
+    std::vector<uint64_t> words;
+    std::vector<uint32_t> super;   // number of ones before each superblock
+    int n = 0;
+    int ones = 0;
+
+public:
+    BitVector(int size = 0) : n(size) {
+        words.assign((size + 63) / 64 + 1, 0);
+    }
+
+    int size() const { return n; }
+    int count_ones() const { return ones; }
+
+    void set(int i) { words[i >> 6] |= uint64_t(1) << (i & 63); }
+    bool get(int i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+
+    // must be called after the last set()
+    void build() {
+        super.assign((words.size() + WORDS_PER_BLOCK - 1) / WORDS_PER_BLOCK, 0);
+        uint32_t acc = 0;
+        for (size_t w = 0; w < words.size(); ++w) {
+            if (w % WORDS_PER_BLOCK == 0) super[w / WORDS_PER_BLOCK] = acc;
+            acc += __builtin_popcountll(words[w]);
+        }
+        ones = static_cast<int>(acc);
+    }
+
+    // number of ones in [0, i)
+    int rank1(int i) const {
+        int w = i >> 6;
+        int s = w / WORDS_PER_BLOCK;
+        uint32_t r = super[s];
+        for (int k = s * WORDS_PER_BLOCK; k < w; ++k) r += __builtin_popcountll(words[k]);
+        uint64_t mask = (uint64_t(1) << (i & 63)) - 1;
+        return static_cast<int>(r + __builtin_popcountll(words[w] & mask));
+    }
+    int rank0(int i) const { return i - rank1(i); }
+
+    // position of the k-th one (0-based), -1 if it does not exist
+    int select1(int k) const {
+        if (k < 0 || k >= ones) return -1;
+        // last superblock whose prefix count is <= k
+        int lo = 0, hi = static_cast<int>(super.size());
+        while (hi - lo > 1) {
+            int mid = (lo + hi) / 2;
+            if (static_cast<int>(super[mid]) <= k) lo = mid; else hi = mid;
+        }
+        int left = k - static_cast<int>(super[lo]);
+        for (int w = lo * WORDS_PER_BLOCK;; ++w) {
+            int c = __builtin_popcountll(words[w]);
+            if (left < c) {
+                uint64_t x = words[w];
+                for (int j = 0; j < left; ++j) x &= x - 1;
+                return w * 64 + __builtin_ctzll(x);
+            }
+            left -= c;
+        }
+    }
+
+    // position of the k-th zero (0-based), -1 if it does not exist
+    int select0(int k) const {
+        if (k < 0 || k >= n - ones) return -1;
+        int lo = 0, hi = n;   // smallest i with rank0(i + 1) > k
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (rank0(mid + 1) > k) hi = mid; else lo = mid + 1;
+        }
+        return lo;
+    }
+
+    size_t memory_bytes() const {
+        return words.size() * sizeof(uint64_t) + super.size() * sizeof(uint32_t);
+    }
+};
+
+// WaveletMatrix: succinct index over non-negative integers.
+// supports access, rank, select, k-th smallest and range frequency, each in O(bits) rank calls.
+template <typename T>
+class WaveletMatrix {
+private:
+    int n = 0;
+    int bits = 0;
+    std::vector<BitVector> level;   // level[0] is the most significant bit
+    std::vector<int> zeros;         // number of zeros in each level
+
+    static int bit_width(uint64_t x) {
+        return x == 0 ? 1 : 64 - __builtin_clzll(x);
+    }
+
+public:
+    WaveletMatrix() = default;
+    WaveletMatrix(const std::vector<T>& raw, int num_threads = 1) : n(static_cast<int>(raw.size())) {
+        uint64_t max_value = 0;
+        for (const T& v : raw) {
+            if (v < 0) throw std::invalid_argument("WaveletMatrix: values must be non-negative");
+            max_value = std::max<uint64_t>(max_value, static_cast<uint64_t>(v));
+        }
+        bits = bit_width(max_value);
+        level.assign(bits, BitVector(n));
+        zeros.assign(bits, 0);
+
+        std::vector<uint64_t> cur(raw.begin(), raw.end()), nxt(n);
+        // split into word-aligned chunks so threads never share a bitvector word
+        const int chunk = std::max(64, ((n + std::max(1, num_threads) - 1) / std::max(1, num_threads) + 63) / 64 * 64);
+        const int num_chunks = (n + chunk - 1) / chunk;
+        std::vector<int> chunk_zeros(num_chunks), chunk_ones(num_chunks);
+        for (int d = 0; d < bits; ++d) {
+            int shift = bits - 1 - d;
+            BitVector& bv = level[d];
+            // 1. mark bits and count zeros per chunk
+            parallel_chunks(num_chunks, num_threads, [&](int cb, int ce) {
+                for (int c = cb; c < ce; ++c) {
+                    int begin = c * chunk, end = std::min(n, begin + chunk), z = 0;
+                    for (int i = begin; i < end; ++i) {
+                        if ((cur[i] >> shift) & 1) bv.set(i); else ++z;
+                    }
+                    chunk_zeros[c] = z;
+                    chunk_ones[c] = (end - begin) - z;
+                }
+            });
+            // 2. exclusive prefix sums give each chunk its output positions
+            int zacc = 0, oacc = 0;
+            for (int c = 0; c < num_chunks; ++c) {
+                int z = chunk_zeros[c], o = chunk_ones[c];
+                chunk_zeros[c] = zacc; zacc += z;
+                chunk_ones[c] = oacc; oacc += o;
+            }
+            zeros[d] = zacc;
+            // 3. stable partition: zeros first, then ones
+            parallel_chunks(num_chunks, num_threads, [&](int cb, int ce) {
+                for (int c = cb; c < ce; ++c) {
+                    int begin = c * chunk, end = std::min(n, begin + chunk);
+                    int zp = chunk_zeros[c], op = zacc + chunk_ones[c];
+                    for (int i = begin; i < end; ++i) {
+                        if ((cur[i] >> shift) & 1) nxt[op++] = cur[i]; else nxt[zp++] = cur[i];
+                    }
+                }
+            });
+            bv.build();
+            std::swap(cur, nxt);
+        }
+    }
+
+    int size() const { return n; }
+
+    size_t memory_bytes() const {
+        size_t total = zeros.size() * sizeof(int);
+        for (const auto& bv : level) total += bv.memory_bytes();
+        return total;
+    }
+
+    // value at index i
+    T access(int i) const {
+        if (i < 0 || i >= n) throw std::out_of_range("WaveletMatrix::access: index out of range");
+        uint64_t v = 0;
+        for (int d = 0; d < bits; ++d) {
+            const BitVector& bv = level[d];
+            if (bv.get(i)) {
+                v |= uint64_t(1) << (bits - 1 - d);
+                i = zeros[d] + bv.rank1(i);
+            } else {
+                i = bv.rank0(i);
+            }
+        }
+        return static_cast<T>(v);
+    }
+
+    // occurrences of value in [0, r) (r is exclusive so rank(v, size()) counts all)
+    int rank(T value, int r) const {
+        if (r < 0 || r > n) throw std::out_of_range("WaveletMatrix::rank: index out of range");
+        if (value < 0 || (bits < 64 && (static_cast<uint64_t>(value) >> bits) != 0)) return 0;
+        int l = 0;
+        for (int d = 0; d < bits; ++d) {
+            const BitVector& bv = level[d];
+            if ((static_cast<uint64_t>(value) >> (bits - 1 - d)) & 1) {
+                l = zeros[d] + bv.rank1(l);
+                r = zeros[d] + bv.rank1(r);
+            } else {
+                l = bv.rank0(l);
+                r = bv.rank0(r);
+            }
+        }
+        return r - l;
+    }
+
+    // position of the k-th (0-based) occurrence of value, -1 if it does not exist
+    int select(T value, int k) const {
+        if (k < 0 || rank(value, n) <= k) return -1;
+        // descend to find where value's run starts in the last level
+        int l = 0;
+        for (int d = 0; d < bits; ++d) {
+            const BitVector& bv = level[d];
+            if ((static_cast<uint64_t>(value) >> (bits - 1 - d)) & 1) l = zeros[d] + bv.rank1(l);
+            else l = bv.rank0(l);
+        }
+        int pos = l + k;
+        // climb back up, inverting each stable partition with select
+        for (int d = bits - 1; d >= 0; --d) {
+            const BitVector& bv = level[d];
+            if ((static_cast<uint64_t>(value) >> (bits - 1 - d)) & 1) pos = bv.select1(pos - zeros[d]);
+            else pos = bv.select0(pos);
+        }
+        return pos;
+    }
+
+    // k-th smallest (0-based) in [l, r] inclusive
+    T kth_smallest(int l, int r, int k) const {
+        if (l < 0 || r >= n || l > r) throw std::out_of_range("WaveletMatrix::kth_smallest: invalid range");
+        if (k < 0 || k > r - l) throw std::out_of_range("WaveletMatrix::kth_smallest: k out of range");
+        ++r;
+        uint64_t v = 0;
+        for (int d = 0; d < bits; ++d) {
+            const BitVector& bv = level[d];
+            int zl = bv.rank0(l), zr = bv.rank0(r);
+            int z = zr - zl;
+            if (k < z) {
+                l = zl; r = zr;
+            } else {
+                k -= z;
+                v |= uint64_t(1) << (bits - 1 - d);
+                l = zeros[d] + (l - zl);
+                r = zeros[d] + (r - zr);
+            }
+        }
+        return static_cast<T>(v);
+    }
+
+    // number of values in [l, r] inclusive that are < upper
+    int count_less(int l, int r, T upper) const {
+        if (l < 0 || r >= n || l > r) throw std::out_of_range("WaveletMatrix::count_less: invalid range");
+        if (upper <= 0) return 0;
+        if (bits < 64 && (static_cast<uint64_t>(upper) >> bits) != 0) return r - l + 1;
+        ++r;
+        int res = 0;
+        for (int d = 0; d < bits; ++d) {
+            const BitVector& bv = level[d];
+            int zl = bv.rank0(l), zr = bv.rank0(r);
+            if ((static_cast<uint64_t>(upper) >> (bits - 1 - d)) & 1) {
+                res += zr - zl;
+                l = zeros[d] + (l - zl);
+                r = zeros[d] + (r - zr);
+            } else {
+                l = zl; r = zr;
+            }
+        }
+        return res;
+    }
+
+    // number of values in [l, r] inclusive with lower <= value < upper
+    int range_freq(int l, int r, T lower, T upper) const {
+        if (lower >= upper) return 0;
+        return count_less(l, r, upper) - count_less(l, r, lower);
+    }
+};
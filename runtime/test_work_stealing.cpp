@@ -0,0 +1,111 @@
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include "work_stealing.cpp"
+
+// naive recursive fib with fork/join at every level above the cutoff
+static long long fib(int n) {
+    if (n < 2) return n;
+    if (n < 12) return fib(n - 1) + fib(n - 2);
+    long long a = 0, b = 0;
+    ws::TaskGroup g;
+    g.run([&] { a = fib(n - 1); });
+    b = fib(n - 2);
+    g.wait();
+    return a + b;
+}
+
+int main() {
+    using namespace std;
+    for (int threads : {1, 2, 4}) {
+        ws::set_num_threads(threads);
+        assert(ws::num_threads() == threads);
+
+        // parallel_for covers every index exactly once, in pieces no larger than grain
+        vector<int> hits(100003, 0);
+        atomic<int> too_big{0};
+        ws::parallel_for(0, static_cast<int64_t>(hits.size()), 1000, [&](int64_t b, int64_t e) {
+            if (e - b > 1000) ++too_big;
+            for (int64_t i = b; i < e; ++i) ++hits[i];
+        });
+        assert(too_big == 0);
+        for (int h : hits) assert(h == 1);
+        ws::parallel_for(5, 5, 10, [&](int64_t, int64_t) { assert(false); });
+
+        // parallel_reduce keeps left-to-right order for a non-commutative monoid
+        string s = ws::parallel_reduce<string>(0, 26, 3, string(),
+            [](int64_t b, int64_t e) {
+                string r;
+                for (int64_t i = b; i < e; ++i) r.push_back(static_cast<char>('a' + i));
+                return r;
+            },
+            [](const string& x, const string& y) { return x + y; });
+        assert(s == "abcdefghijklmnopqrstuvwxyz");
+        long long sum = ws::parallel_reduce<long long>(1, 1000001, 4096, 0,
+            [](int64_t b, int64_t e) { long long r = 0; for (int64_t i = b; i < e; ++i) r += i; return r; },
+            [](long long x, long long y) { return x + y; });
+        assert(sum == 500000500000LL);
+
+        // nested fork/join
+        assert(fib(25) == 75025);
+
+        // the first failure is rethrown by wait(), the group stays usable
+        ws::TaskGroup g;
+        atomic<int> ran{0};
+        for (int i = 0; i < 50; ++i) {
+            g.run([&, i] {
+                ++ran;
+                if (i == 17) throw runtime_error("boom");
+            });
+        }
+        bool threw = false;
+        try { g.wait(); } catch (const runtime_error&) { threw = true; }
+        assert(threw && ran == 50);
+        g.run([&] { ++ran; });
+        g.wait();
+        assert(ran == 51);
+
+        threw = false;
+        try {
+            ws::parallel_for(0, 1000, 10, [](int64_t b, int64_t) { if (b == 500) throw out_of_range("x"); });
+        } catch (const out_of_range&) { threw = true; }
+        assert(threw);
+    }
+
+    // max_workers caps how many threads run the body at once, on a wider pool
+    ws::set_num_threads(4);
+    for (int cap : {1, 2, 3}) {
+        vector<int> hits(5000, 0);
+        atomic<int> active{0}, peak{0};
+        ws::parallel_for(0, static_cast<int64_t>(hits.size()), 50, [&](int64_t b, int64_t e) {
+            int now = ++active;
+            for (int seen = peak.load(); now > seen && !peak.compare_exchange_weak(seen, now);) {}
+            this_thread::sleep_for(chrono::microseconds(200));
+            for (int64_t i = b; i < e; ++i) ++hits[i];
+            --active;
+        }, cap);
+        assert(peak <= cap);
+        for (int h : hits) assert(h == 1);
+    }
+
+    // calls from several outside threads share slot 0 safely
+    ws::set_num_threads(3);
+    vector<thread> callers;
+    atomic<long long> total{0};
+    for (int t = 0; t < 4; ++t) {
+        callers.emplace_back([&] {
+            total += ws::parallel_reduce<long long>(0, 100000, 1000, 0,
+                [](int64_t b, int64_t e) { return static_cast<long long>(e - b); },
+                [](long long x, long long y) { return x + y; });
+        });
+    }
+    for (auto& c : callers) c.join();
+    assert(total == 400000);
+
+    cout << "Work-stealing runtime tests passed" << endl;
+    return 0;
+}
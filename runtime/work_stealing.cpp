@@ -0,0 +1,317 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+// Shared work-stealing runtime for the algebra sieves and data-structure builds.
+//
+//   ws::pool()              process-wide pool, DS_NUM_THREADS or hardware_concurrency() wide
+//   ws::set_num_threads(n)  rebuild the pool with n-way concurrency (call while it is idle)
+//   ws::TaskGroup           fork/join: run() forks a task, wait() joins and rethrows
+//   ws::parallel_for        f(b, e) over grain-sized subranges, split recursively; with a
+//                           max_workers argument at most that many threads run f at once
+//   ws::parallel_reduce     map(b, e) over subranges folded with an associative combine, in order
+//
+// Every worker owns a deque: it pushes and pops its own tasks at the back (LIFO, cache-warm)
+// while idle workers steal from the front of a random victim (FIFO, the largest pieces).
+// A thread waiting on a TaskGroup runs queued tasks instead of blocking, so fork/join nests freely.
+// With concurrency 1 there are no workers and everything runs inline on the caller.
+namespace ws {
+
+class TaskGroup;
+class ThreadPool;
+
+namespace detail {
+inline thread_local ThreadPool* current_pool = nullptr;
+inline thread_local int current_slot = 0;
+}
+
+class ThreadPool {
+private:
+    struct Task {
+        std::function<void()> fn;
+        TaskGroup* group;
+    };
+    // slot 0 is shared by threads outside the pool, slot i > 0 belongs to worker i
+    struct alignas(64) Slot {
+        std::mutex mu;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Slot>> slots;
+    std::vector<std::thread> workers;
+    std::atomic<int64_t> queued{0};
+    std::atomic<int> sleepers{0};
+    std::atomic<bool> stopping{false};
+    std::mutex sleep_mu;
+    std::condition_variable sleep_cv;
+
+    int own_slot() const {
+        return detail::current_pool == this ? detail::current_slot : 0;
+    }
+
+    bool pop_back(int s, Task& t) {
+        std::lock_guard<std::mutex> guard(slots[s]->mu);
+        if (slots[s]->tasks.empty()) return false;
+        t = std::move(slots[s]->tasks.back());
+        slots[s]->tasks.pop_back();
+        return true;
+    }
+
+    bool steal_front(int s, Task& t) {
+        std::unique_lock<std::mutex> lock(slots[s]->mu, std::try_to_lock);
+        if (!lock.owns_lock() || slots[s]->tasks.empty()) return false;
+        t = std::move(slots[s]->tasks.front());
+        slots[s]->tasks.pop_front();
+        return true;
+    }
+
+    void execute(Task& t);
+
+    void worker_loop(int slot) {
+        detail::current_pool = this;
+        detail::current_slot = slot;
+        while (!stopping.load(std::memory_order_acquire)) {
+            if (run_one()) continue;
+            std::unique_lock<std::mutex> lock(sleep_mu);
+            sleepers.fetch_add(1);
+            sleep_cv.wait(lock, [&] { return queued.load() > 0 || stopping.load(); });
+            sleepers.fetch_sub(1);
+        }
+    }
+
+public:
+    explicit ThreadPool(int concurrency) {
+        concurrency = std::max(1, concurrency);
+        for (int i = 0; i < concurrency; ++i) slots.emplace_back(new Slot);
+        for (int i = 1; i < concurrency; ++i) workers.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> guard(sleep_mu);
+            stopping.store(true);
+        }
+        sleep_cv.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    int concurrency() const { return static_cast<int>(slots.size()); }
+
+    void push(std::function<void()> fn, TaskGroup* group) {
+        int s = own_slot();
+        {
+            std::lock_guard<std::mutex> guard(slots[s]->mu);
+            slots[s]->tasks.push_back(Task{std::move(fn), group});
+        }
+        queued.fetch_add(1);
+        if (sleepers.load() > 0) {
+            // taking the lock orders this notify after a sleeper's predicate check
+            std::lock_guard<std::mutex> guard(sleep_mu);
+            sleep_cv.notify_one();
+        }
+    }
+
+    // run one task, own deque first, otherwise stolen; false if none was found
+    bool run_one() {
+        if (queued.load(std::memory_order_relaxed) == 0) return false;
+        int s = own_slot();
+        Task t;
+        bool found = pop_back(s, t);
+        if (!found) {
+            static thread_local uint32_t seed = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1;
+            seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+            int n = concurrency();
+            for (int k = 0, v = static_cast<int>(seed % n); k < n && !found; ++k, v = v + 1 == n ? 0 : v + 1) {
+                if (v != s) found = steal_front(v, t);
+            }
+        }
+        if (!found) return false;
+        queued.fetch_sub(1);
+        execute(t);
+        return true;
+    }
+};
+
+// fork/join scope: tasks forked with run() may reference the caller's stack until wait() returns
+class TaskGroup {
+private:
+    friend class ThreadPool;
+    ThreadPool& pool;
+    std::atomic<int64_t> pending{0};
+    std::mutex error_mu;
+    std::exception_ptr error;
+
+    void fail(std::exception_ptr e) {
+        std::lock_guard<std::mutex> guard(error_mu);
+        if (!error) error = e;
+    }
+
+public:
+    explicit TaskGroup(ThreadPool& p);
+    TaskGroup();
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    ~TaskGroup() {
+        while (pending.load() > 0) {
+            if (!pool.run_one()) std::this_thread::yield();
+        }
+    }
+
+    template <typename F>
+    void run(F&& f) {
+        if (pool.concurrency() == 1) {
+            try { f(); } catch (...) { fail(std::current_exception()); }
+            return;
+        }
+        pending.fetch_add(1);
+        pool.push(std::function<void()>(std::forward<F>(f)), this);
+    }
+
+    // join every forked task, helping with queued work meanwhile; rethrows the first failure
+    void wait() {
+        while (pending.load(std::memory_order_acquire) > 0) {
+            if (!pool.run_one()) std::this_thread::yield();
+        }
+        if (error) {
+            std::exception_ptr e = error;
+            error = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+};
+
+inline void ThreadPool::execute(Task& t) {
+    try {
+        t.fn();
+    } catch (...) {
+        t.group->fail(std::current_exception());
+    }
+    t.group->pending.fetch_sub(1, std::memory_order_release);
+}
+
+inline int default_concurrency() {
+    if (const char* env = std::getenv("DS_NUM_THREADS")) {
+        int n = std::atoi(env);
+        if (n > 0) return n;
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+namespace detail {
+inline std::mutex pool_mu;
+inline std::unique_ptr<ThreadPool> global_pool;
+}
+
+inline ThreadPool& pool() {
+    std::lock_guard<std::mutex> guard(detail::pool_mu);
+    if (!detail::global_pool) detail::global_pool.reset(new ThreadPool(default_concurrency()));
+    return *detail::global_pool;
+}
+
+inline void set_num_threads(int n) {
+    std::lock_guard<std::mutex> guard(detail::pool_mu);
+    detail::global_pool.reset();
+    detail::global_pool.reset(new ThreadPool(n));
+}
+
+inline int num_threads() { return pool().concurrency(); }
+
+inline TaskGroup::TaskGroup(ThreadPool& p) : pool(p) {}
+inline TaskGroup::TaskGroup() : pool(ws::pool()) {}
+
+// grain that cuts `count` items into about `pieces_per_thread` pieces per thread
+inline int64_t grain_for(int64_t count, int pieces_per_thread = 8) {
+    return std::max<int64_t>(1, count / (static_cast<int64_t>(num_threads()) * pieces_per_thread));
+}
+
+namespace detail {
+template <typename F>
+void split_for(ThreadPool& p, int64_t begin, int64_t end, int64_t grain, const F& f) {
+    TaskGroup g(p);
+    while (end - begin > grain) {
+        int64_t mid = begin + (end - begin) / 2;
+        g.run([&p, mid, end, grain, &f] { split_for(p, mid, end, grain, f); });
+        end = mid;
+    }
+    f(begin, end);
+    g.wait();
+}
+
+template <typename T, typename Map, typename Combine>
+T split_reduce(ThreadPool& p, int64_t begin, int64_t end, int64_t grain, const T& identity, const Map& map, const Combine& combine) {
+    if (end - begin <= grain) return map(begin, end);
+    int64_t mid = begin + (end - begin) / 2;
+    TaskGroup g(p);
+    T right = identity;
+    g.run([&] { right = split_reduce<T>(p, mid, end, grain, identity, map, combine); });
+    T left = split_reduce<T>(p, begin, mid, grain, identity, map, combine);
+    g.wait();
+    return combine(left, right);
+}
+} // namespace detail
+
+// f(b, e) for disjoint subranges of [begin, end), each at most `grain` long
+template <typename F>
+void parallel_for(int64_t begin, int64_t end, int64_t grain, const F& f) {
+    if (end <= begin) return;
+    grain = std::max<int64_t>(1, grain);
+    ThreadPool& p = pool();
+    if (p.concurrency() == 1) {
+        for (int64_t b = begin; b < end; b += grain) f(b, std::min(end, b + grain));
+        return;
+    }
+    detail::split_for(p, begin, end, grain, f);
+}
+
+// as above, but at most max_workers threads (the caller included) run f at once: that many
+// loops pull grain-sized subranges off a shared counter, so uneven pieces still balance
+template <typename F>
+void parallel_for(int64_t begin, int64_t end, int64_t grain, const F& f, int max_workers) {
+    if (end <= begin) return;
+    grain = std::max<int64_t>(1, grain);
+    ThreadPool& p = pool();
+    int64_t pieces = (end - begin + grain - 1) / grain;
+    int workers = static_cast<int>(std::min<int64_t>({static_cast<int64_t>(max_workers), p.concurrency(), pieces}));
+    if (workers <= 1) {
+        for (int64_t b = begin; b < end; b += grain) f(b, std::min(end, b + grain));
+        return;
+    }
+    std::atomic<int64_t> next{begin};
+    auto drain = [&] {
+        for (int64_t b = next.fetch_add(grain); b < end; b = next.fetch_add(grain)) f(b, std::min(end, b + grain));
+    };
+    TaskGroup g(p);
+    for (int i = 1; i < workers; ++i) g.run(drain);
+    drain();
+    g.wait();
+}
+
+// combine over map(b, e) of grain-sized subranges; combine must be associative with `identity`
+// as its unit, it need not be commutative (left-to-right order is kept)
+template <typename T, typename Map, typename Combine>
+T parallel_reduce(int64_t begin, int64_t end, int64_t grain, T identity, const Map& map, const Combine& combine) {
+    if (end <= begin) return identity;
+    grain = std::max<int64_t>(1, grain);
+    ThreadPool& p = pool();
+    if (p.concurrency() == 1) {
+        T acc = identity;
+        for (int64_t b = begin; b < end; b += grain) acc = combine(acc, map(b, std::min(end, b + grain)));
+        return acc;
+    }
+    return detail::split_reduce<T>(p, begin, end, grain, identity, map, combine);
+}
+
+} // namespace ws